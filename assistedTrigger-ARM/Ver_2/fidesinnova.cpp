@@ -15,6 +15,7 @@
 // - MI "inst" text is unescaped ("\\t" -> tab, etc.) before mnemonic parse.
 // - Skip logs show the parsed mnemonic for fast diagnosis.
 // - **NEW:** KZG commitment of the trace polynomial, Fiat–Shamir point z, opening (y,pi), and verification.
+// - KZG commits and openings use a multithreaded Pippenger MSM (msm_pippenger.hpp) over an affine SRS.
 //
 // BUILD
 // -----
@@ -29,7 +30,7 @@
 //   make -j && sudo make install
 //
 // Build this tool:
-//   g++ -std=gnu++17 -O2 -g fidesinnova.cpp -lmcl -lcrypto -o fidesinnova
+//   g++ -std=gnu++17 -O2 -g fidesinnova.cpp -lmcl -lcrypto -pthread -o fidesinnova
 //
 // USAGE
 // -----
@@ -47,6 +48,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <mcl/bn.hpp>
+#include "msm_pippenger.hpp"
 
 static bool g_debug = false;
 static void dbg(const std::string& s){ if(g_debug) fprintf(stderr, "[DBG] %s\n", s.c_str()); }
@@ -620,6 +622,8 @@ struct SRS {
             s.g1_powers[i] = t;
             pow *= tau;
         }
+        // Affine powers let the MSM add them without converting on every commit
+        G1::normalizeVec(s.g1_powers.data(), s.g1_powers.data(), n);
         s.g2_1 = g2;
         mcl::bn::G2::mul(s.g2_tau, g2, tau);
         return s;
@@ -688,20 +692,16 @@ struct SRS {
             std::string k = std::string("g1_")+std::to_string(i)+":";
             deserializePoint(s.g1_powers[i], line(k));
         }
+        G1::normalizeVec(s.g1_powers.data(), s.g1_powers.data(), n);
         return s;
     }
 };
 
 
+// MSM over G1: \sum scalars[i] * bases[i] over the first scalars.size() bases (Pippenger, msm_pippenger.hpp)
 inline G1 msm_g1(const std::vector<G1>& bases, const std::vector<Fr>& scalars){
-    if(bases.size()!=scalars.size()) throw std::runtime_error("msm len mismatch");
-    G1 acc; acc.clear();
-    for(size_t i=0;i<bases.size();++i){
-        if(scalars[i].isZero()) continue;
-        G1 tmp; mcl::bn::G1::mul(tmp, bases[i], scalars[i]);
-        mcl::bn::G1::add(acc, acc, tmp);
-    }
-    return acc;
+    if(scalars.size()>bases.size()) throw std::runtime_error("msm len mismatch");
+    return MSM::pippenger(bases.data(), scalars.data(), scalars.size());
 }
 
 inline G1 commit(const SRS& srs, const std::vector<Fr>& coeffs){
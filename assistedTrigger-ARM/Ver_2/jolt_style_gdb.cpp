@@ -39,7 +39,7 @@ Key engineering points
 
 Tested assumptions
 - Host: ARM64 Ubuntu
-- Build: `g++ -std=gnu++17 -O2 -lmcl -lcrypto`
+- Build: `g++ -std=gnu++17 -O2 -lmcl -lcrypto -pthread`
 - Sample: compile your program with `-O0 -g -fno-pie -no-pie` so ops are visible.
 
 Files optionally used at runtime
@@ -76,6 +76,7 @@ Security notes
 #include <csignal>
 
 #include <mcl/bn.hpp>
+#include "msm_pippenger.hpp"
 using namespace mcl::bn;
 
 // ---------- utils ----------
@@ -166,6 +167,7 @@ static KZGParams kzg_setup(size_t max_deg){
     pp.srs_g1.resize(max_deg+1);
     Fr pow_s = fr_one();
     for (size_t i=0;i<=max_deg;i++){ G1 gi = pp.g1; G1::mul(gi, gi, pow_s); pp.srs_g1[i]=gi; pow_s *= pp.s; }
+    G1::normalizeVec(pp.srs_g1.data(), pp.srs_g1.data(), pp.srs_g1.size());   // affine, for the MSM
     pp.g2_s = pp.g2; G2::mul(pp.g2_s, pp.g2, pp.s);
     return pp;
 }
@@ -174,12 +176,7 @@ static G1 kzg_commit(const KZGParams& pp, const Poly& f){
         throw std::runtime_error("kzg_commit: SRS too small for polynomial degree="
                                  + std::to_string(f.c.size()-1) + ", srs="
                                  + std::to_string(pp.srs_g1.size()-1));
-    G1 acc; acc.clear();
-    for (size_t i=0;i<f.c.size();i++){
-        if (f.c[i].isZero()) continue;
-        G1 term; G1::mul(term, pp.srs_g1[i], f.c[i]); G1::add(acc, acc, term);
-    }
-    return acc;
+    return MSM::pippenger(pp.srs_g1.data(), f.c.data(), f.c.size());
 }
 static void kzg_open(const KZGParams& pp, const Poly& f, const Fr& z, Fr& value_out, G1& witness_out){
     if (f.c.empty()){ value_out.clear(); witness_out.clear(); return; }
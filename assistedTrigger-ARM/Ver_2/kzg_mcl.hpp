@@ -7,7 +7,7 @@
 //   cmake .. -DMCL_STATIC_LIB=ON -DMCL_USE_OPENSSL=ON && make -j
 //   sudo make install
 //
-// Link flags:  -lmcl -lcrypto
+// Link flags:  -lmcl -lcrypto -pthread
 //
 // API summary:
 //   KZG::SRS srs = KZG::SRS::trustedSetup(n);  // or SRS::load(path)
@@ -17,6 +17,7 @@
 
 #pragma once
 #include <mcl/bn256.hpp>
+#include "msm_pippenger.hpp"
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -67,6 +68,9 @@ struct SRS {
             pow *= tau;
         }
 
+        // Affine powers let the MSM add them without converting on every commit
+        mcl::bn::G1::normalizeVec(s.g1_powers.data(), s.g1_powers.data(), n);
+
         // g2_1 = [1]G2 ; g2_tau = [tau]G2
         s.g2_1 = g2;
         mcl::bn::G2::mul(s.g2_tau, g2, tau);
@@ -136,6 +140,7 @@ struct SRS {
             std::string hx = getLine(k);
             deserialize(s.g1_powers[i], hx);
         }
+        mcl::bn::G1::normalizeVec(s.g1_powers.data(), s.g1_powers.data(), n);
         return s;
     }
 };
@@ -172,16 +177,10 @@ inline std::pair<std::vector<Fr>, Fr> divXminusZ(const std::vector<Fr>& a, const
     return {q, y};
 }
 
-// MSM over G1: \sum a_i * SRS[i]
+// MSM over G1: \sum a_i * SRS[i] over the first scalars.size() powers (Pippenger, msm_pippenger.hpp)
 inline G1 msm_g1(const std::vector<G1>& bases, const std::vector<Fr>& scalars){
-    if(bases.size()!=scalars.size()) throw std::runtime_error("msm len mismatch");
-    G1 acc; acc.clear(); // point at infinity
-    for(size_t i=0;i<bases.size();++i){
-        if(scalars[i].isZero()) continue;
-        G1 tmp; mcl::bn::G1::mul(tmp, bases[i], scalars[i]);
-        mcl::bn::G1::add(acc, acc, tmp);
-    }
-    return acc;
+    if(scalars.size()>bases.size()) throw std::runtime_error("msm len mismatch");
+    return MSM::pippenger(bases.data(), scalars.data(), scalars.size());
 }
 
 // Public KZG API
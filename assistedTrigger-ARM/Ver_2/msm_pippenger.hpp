@@ -0,0 +1,216 @@
+// msm_pippenger.hpp
+// Multi-scalar multiplication over mcl G1 (BN254): sum_i s_i * P_i with Pippenger's bucket method.
+//
+// - The scalars are cut into windows of c bits, with c chosen from the number of points, and recoded into signed
+//   digits in [-2^(c-1), 2^(c-1)), so each window needs only 2^(c-1) buckets: a point with a negative digit goes
+//   into the bucket of |d| with its y negated.
+// - Points are added into their buckets in affine coordinates. A batch of additions into distinct buckets shares
+//   one field inversion (Montgomery's trick); a point whose bucket already has an addition in the batch waits for
+//   the next one.
+// - The windows are independent, so they are accumulated on separate threads and combined at the end with
+//   c doublings per window.
+//
+// Used by msm_g1 in fidesinnova.cpp and kzg_mcl.hpp and by kzg_commit in jolt_style_vm.cpp. Header only; the
+// includer links -lmcl as before and builds with -pthread.
+//
+// API summary:
+//   G1 r = MSM::pippenger(bases.data(), scalars.data(), n);       // threads = hardware concurrency
+//   G1 r = MSM::pippenger(bases.data(), scalars.data(), n, 1);    // single-threaded
+
+#pragma once
+#include <mcl/bn.hpp>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+namespace MSM {
+
+using Fp = mcl::bn::Fp;
+using Fr = mcl::bn::Fr;
+using G1 = mcl::bn::G1;
+
+// Below this many points the bucket bookkeeping costs more than it saves
+static const size_t NAIVE_LIMIT = 16;
+
+// Window size in bits for n points: about 0.69 * log2(n) + 2, which balances the n additions per window against
+// the 2^c additions that sum its buckets
+inline size_t windowBits(size_t n){
+    size_t logN = 0;
+    while((size_t(1) << logN) < n) logN++;
+    return std::min<size_t>(16, std::max<size_t>(2, logN * 69 / 100 + 2));
+}
+
+// Bits [offset, offset + c) of a little-endian scalar
+inline uint32_t scalarBits(const mcl::fp::Unit* units, size_t unitCount, size_t offset, size_t c){
+    const size_t unitBits = sizeof(mcl::fp::Unit) * 8;
+    uint64_t bits = 0;
+    for(size_t read = 0; read < c; ){
+        size_t bit = offset + read;
+        size_t unit = bit / unitBits, shift = bit % unitBits;
+        if(unit >= unitCount) break;
+        size_t take = std::min(c - read, unitBits - shift);
+        uint64_t chunk = (uint64_t)(units[unit] >> shift) & ((uint64_t(1) << take) - 1);
+        bits |= chunk << read;
+        read += take;
+    }
+    return (uint32_t)bits;
+}
+
+// Signed digits of every scalar, windows of point i at digits[i * windows ... ]
+inline void recodeScalars(const Fr* scalars, size_t n, size_t c, size_t windows, std::vector<int32_t>& digits, unsigned threads){
+    digits.assign(n * windows, 0);
+    const int64_t half = int64_t(1) << (c - 1), full = int64_t(1) << c;
+    auto recode = [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            mcl::fp::Block block;
+            scalars[i].getBlock(block);
+            int64_t carry = 0;
+            for(size_t w = 0; w < windows; w++){
+                int64_t v = (int64_t)scalarBits(block.p, block.n, w * c, c) + carry;
+                carry = v >= half ? 1 : 0;
+                digits[i * windows + w] = (int32_t)(v - carry * full);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    size_t chunk = (n + threads - 1) / threads;
+    for(size_t begin = chunk; begin < n; begin += chunk) workers.emplace_back(recode, begin, std::min(n, begin + chunk));
+    recode(0, std::min(n, chunk));
+    for(auto& t: workers) t.join();
+}
+
+// Affine buckets of one window, filled with batched affine additions
+struct Buckets {
+    std::vector<Fp> x, y;
+    std::vector<uint8_t> filled, busy;
+
+    // Additions waiting for the batch inversion: bucket, point and the denominator of the slope
+    struct Pending { size_t bucket; Fp px, py, num, den; };
+    std::vector<Pending> pending;
+    std::vector<Fp> prefix;
+
+    explicit Buckets(size_t count): x(count), y(count), filled(count, 0), busy(count, 0) {}
+
+    // Slopes of every pending addition from one inversion, then x3 = l^2 - x1 - x2, y3 = l (x1 - x3) - y1
+    void flush(){
+        if(pending.empty()) return;
+        prefix.resize(pending.size());
+        Fp acc = 1;
+        for(size_t i = 0; i < pending.size(); i++){ prefix[i] = acc; acc *= pending[i].den; }
+        Fp inv; Fp::inv(inv, acc);
+        for(size_t i = pending.size(); i-- > 0; ){
+            Pending& e = pending[i];
+            Fp lambda = inv * prefix[i] * e.num;
+            inv *= e.den;
+            size_t k = e.bucket;
+            Fp x3 = lambda * lambda - x[k] - e.px;
+            y[k] = lambda * (x[k] - x3) - y[k];
+            x[k] = x3;
+            busy[k] = 0;
+        }
+        pending.clear();
+    }
+
+    // Add the affine point (px, py) into bucket k; returns false if k already has an addition in this batch
+    bool add(size_t k, const Fp& px, const Fp& py, size_t batch){
+        if(busy[k]) return false;
+        if(!filled[k]){ x[k] = px; y[k] = py; filled[k] = 1; return true; }
+        Pending e{k, px, py, Fp(), Fp()};
+        if(px == x[k]){
+            if(py != y[k]){ filled[k] = 0; return true; }   // P + (-P) = O
+            Fp xx = px * px;
+            e.num = xx + xx + xx;                            // doubling: l = 3x^2 / 2y (a = 0)
+            e.den = py + py;
+        }else{
+            e.num = py - y[k];
+            e.den = px - x[k];
+        }
+        busy[k] = 1;
+        pending.push_back(e);
+        if(pending.size() >= batch) flush();
+        return true;
+    }
+};
+
+// Sum of the digits of window w times the points: bucket accumulation, then sum_k k * B_k as a running sum
+inline G1 windowSum(const G1* bases, const std::vector<int32_t>& digits, size_t n, size_t windows, size_t w, size_t c){
+    const size_t bucketCount = size_t(1) << (c - 1);
+    Buckets buckets(bucketCount);
+    const size_t batch = std::max<size_t>(64, std::min<size_t>(1024, bucketCount / 2));
+    std::vector<size_t> waiting, retry;
+    for(size_t i = 0; i < n; i++){
+        if(digits[i * windows + w] != 0 && !bases[i].isZero()) waiting.push_back(i);
+    }
+    while(!waiting.empty()){
+        retry.clear();
+        for(size_t i: waiting){
+            int32_t d = digits[i * windows + w];
+            Fp py = bases[i].y;
+            if(d < 0) Fp::neg(py, py);
+            if(!buckets.add(size_t(d < 0 ? -d : d) - 1, bases[i].x, py, batch)) retry.push_back(i);
+        }
+        buckets.flush();
+        waiting.swap(retry);
+    }
+
+    G1 running, sum, bucket;
+    running.clear(); sum.clear();
+    for(size_t k = bucketCount; k-- > 0; ){
+        if(buckets.filled[k]){
+            bucket.x = buckets.x[k]; bucket.y = buckets.y[k]; bucket.z = 1;
+            G1::add(running, running, bucket);
+        }
+        G1::add(sum, sum, running);
+    }
+    return sum;
+}
+
+// sum_i scalars[i] * bases[i]; threads = 0 uses every core
+inline G1 pippenger(const G1* bases, const Fr* scalars, size_t n, unsigned threads = 0){
+    G1 result; result.clear();
+    if(n == 0) return result;
+    if(n < NAIVE_LIMIT){
+        for(size_t i = 0; i < n; i++){
+            if(scalars[i].isZero()) continue;
+            G1 term; G1::mul(term, bases[i], scalars[i]);
+            G1::add(result, result, term);
+        }
+        return result;
+    }
+
+    // The bucket additions read affine coordinates; an SRS normalized once at setup skips the copy
+    std::vector<G1> normalized;
+    bool affine = std::all_of(bases, bases + n, [](const G1& P){ return P.isNormalized(); });
+    if(!affine){
+        normalized.resize(n);
+        G1::normalizeVec(normalized.data(), bases, n);
+        bases = normalized.data();
+    }
+
+    if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t c = windowBits(n);
+    // At least two bits to spare above the scalar, so the carry of the signed digits ends in the last window
+    const size_t windows = (Fr::getBitSize() + 1) / c + 1;
+    std::vector<int32_t> digits;
+    recodeScalars(scalars, n, c, windows, digits, threads);
+
+    std::vector<G1> sums(windows);
+    std::vector<std::thread> workers;
+    size_t workerCount = std::min<size_t>(threads, windows);
+    for(size_t t = 0; t < workerCount; t++){
+        workers.emplace_back([&, t]{
+            for(size_t w = t; w < windows; w += workerCount) sums[w] = windowSum(bases, digits, n, windows, w, c);
+        });
+    }
+    for(auto& worker: workers) worker.join();
+
+    result = sums[windows - 1];
+    for(size_t w = windows - 1; w-- > 0; ){
+        for(size_t b = 0; b < c; b++) G1::dbl(result, result);
+        G1::add(result, result, sums[w]);
+    }
+    return result;
+}
+
+} // namespace MSM
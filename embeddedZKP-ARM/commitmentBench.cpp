@@ -0,0 +1,159 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lib/commitmentBackend.h"
+#include "lib/jsonLoader.h"
+#include "lib/fidesRandom.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Function to get the milliseconds since start
+static double millisecondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Function to create a random polynomial of size coefficients in p
+static vector<uint64_t> randomPolynomial(size_t size, uint64_t p, FidesRandom::Engine& rng) {
+  vector<uint64_t> poly(size);
+  for (uint64_t& coefficient : poly) {
+    coefficient = rng() % p;
+  }
+  return poly;
+}
+
+// Function to check a division as the succinct openings check s(x) with every backend: that the commitment of
+// q Z is accepted as quotient q times divisor Z, and that of q + 1 is not. Z has the size of Z_s(x); the coefficients
+// are below 4, so the products in p are the products of integers and every backend reads them as the same
+// polynomials
+static bool divisionHolds(const CommitmentBackend& backend, size_t size, uint64_t p, FidesRandom::Engine& rng) {
+  vector<uint64_t> divisor = randomPolynomial(33, 4, rng);
+  vector<uint64_t> quotient = randomPolynomial(max(min(size, backend.maxSize()), divisor.size()) - divisor.size() + 1, 4, rng);
+  vector<uint64_t> product = Polynomial::multiplyPolynomials(quotient, divisor, p);
+  vector<uint64_t> wrongQuotient = quotient;
+  wrongQuotient[0] += 1;
+  CommitmentBackend::Element commitment = backend.commit(product), divisorCommitment = backend.commitDivisor(divisor);
+  return backend.verifyDivision(commitment, backend.commit(quotient), divisorCommitment)
+    && !backend.verifyDivision(commitment, backend.commit(wrongQuotient), divisorCommitment);
+}
+
+// Function to time the commitment work of one proof of a class with every backend of this build: the twelve
+// commitments of the prover (w_hat, z_hatA, z_hatB, z_hatC, h_0, s, g_1 and h_1 over H with up to 2n coefficients,
+// g_2, h_2, g_3 and h_3 over K with up to 3m), one opening of those and the nine index polynomials at one point
+// weighted like p(x), and its verification, and to check a division with divisionHolds. The polynomials are random,
+// with the sizes of the class
+static void benchClass(uint64_t Class, JsonLoader& classJson) {
+  std::string key = "/" + to_string(Class);
+  uint64_t n = classJson.number(key + "/n"), m = classJson.number(key + "/m");
+  uint64_t p = classJson.number(key + "/p"), g = classJson.number(key + "/g");
+  JsonLoader setupJson;
+  if (!setupJson.loadFile("data/setup" + to_string(Class) + ".json")) {
+    throw std::runtime_error("Error: Fides cannot read data/setup" + to_string(Class) + ".json");
+  }
+  vector<uint64_t> ck = setupJson.take("/ck");
+  uint64_t vk = setupJson.number("/vk");
+
+  FidesRandom::Engine rng = FidesRandom::engine();
+  vector<vector<uint64_t>> committed, index;
+  for (int i = 0; i < 8; i++) {
+    committed.push_back(randomPolynomial(min<size_t>(2 * n, ck.size()), p, rng));
+  }
+  for (int i = 0; i < 4; i++) {
+    committed.push_back(randomPolynomial(min<size_t>(3 * m, ck.size()), p, rng));
+  }
+  for (int i = 0; i < 9; i++) {
+    index.push_back(randomPolynomial(min<size_t>(m, ck.size()), p, rng));
+  }
+  uint64_t point = rng() % p;
+
+  for (const std::string& name : CommitmentBackend::available()) {
+    auto start = chrono::steady_clock::now();
+    unique_ptr<CommitmentBackend> backend = CommitmentBackend::create(name, ck, vk, g, p);
+    double setupMs = millisecondsSince(start);
+
+    vector<CommitmentBackend::Element> commitments;
+    for (const vector<uint64_t>& poly : index) {
+      commitments.push_back(backend->commit(poly));
+    }
+    start = chrono::steady_clock::now();
+    for (const vector<uint64_t>& poly : committed) {
+      commitments.push_back(backend->commit(poly));
+    }
+    double commitMs = millisecondsSince(start);
+
+    vector<const vector<uint64_t>*> polys;
+    vector<uint64_t> weights;
+    for (const vector<vector<uint64_t>>* group : { &index, &committed }) {
+      for (const vector<uint64_t>& poly : *group) {
+        polys.push_back(&poly);
+        weights.push_back(rng() % p);
+      }
+    }
+    start = chrono::steady_clock::now();
+    CommitmentBackend::Opening opening = backend->open(polys, weights, point);
+    double openMs = millisecondsSince(start);
+
+    start = chrono::steady_clock::now();
+    bool verified = backend->verify(commitments, weights, point, opening);
+    double verifyMs = millisecondsSince(start);
+    bool divides = divisionHolds(*backend, 2 * n, p, rng);
+
+    size_t bytes = opening.proof.size();
+    for (size_t i = index.size(); i < commitments.size(); i++) {
+      bytes += commitments[i].size();
+    }
+    cout << setw(5) << Class << setw(8) << name << fixed << setprecision(2) << setw(12) << setupMs << setw(12) << commitMs
+         << setw(12) << openMs << setw(12) << verifyMs << setw(8) << bytes << setw(10) << (verified ? "yes" : "NO")
+         << setw(10) << (divides ? "yes" : "NO") << endl;
+  }
+}
+
+// Benchmark of the commitment backends: "commitmentBench [class ...]" runs classes 1 to 10 by default, reading
+// class.json and data/setupN.json from the working directory, and prints the milliseconds to build the backend from
+// the setup, commit, open and verify, the bytes of the commitments and opening proof of one proof, and whether the
+// opening and a division check as expected.
+// Build with -DFIDES_KZG_MCL -lmcl to compare the BN254 backend with the mod p one.
+int main(int argc, char* argv[]) {
+  vector<uint64_t> classes;
+  for (int i = 1; i < argc; i++) {
+    classes.push_back(strtoull(argv[i], nullptr, 10));
+  }
+  if (classes.empty()) {
+    for (uint64_t Class = 1; Class <= 10; Class++) {
+      classes.push_back(Class);
+    }
+  }
+
+  try {
+    JsonLoader classJson;
+    if (!classJson.loadFile("class.json")) {
+      throw std::runtime_error("Error: Fides cannot read class.json");
+    }
+    cout << setw(5) << "class" << setw(8) << "backend" << setw(12) << "setup ms" << setw(12) << "commit ms"
+         << setw(12) << "open ms" << setw(12) << "verify ms" << setw(8) << "bytes" << setw(10) << "verified"
+         << setw(10) << "divides" << endl;
+    for (uint64_t Class : classes) {
+      benchClass(Class, classJson);
+    }
+  } catch (const std::exception& error) {
+    cerr << error.what() << endl;
+    return 2;
+  }
+  return 0;
+}
@@ -14,6 +14,8 @@
 
 
 #include "lib/polynomial.h"
+#include "lib/fidesLog.h"
+#include "lib/jsonLoader.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -52,6 +54,7 @@ uint64_t n_i, n_g, m, n, p, g;
 std::string configFilePath = "device_config.json", setupFilePath, assemblyFilePath = "program.s", newAssemblyFile = "program_new.s", commitmentFileName, paramFileName;
 
 std::vector<std::string> instructions;
+uint64_t codeBlockStart;
 uint64_t Class;
 string commitmentID;
 string deviceType;
@@ -82,20 +85,17 @@ std::pair<uint64_t, uint64_t> parseDeviceConfig(const std::string &configFile, n
   softwareVersion = config["softwareVersion"].get<string>();
 
   
-  std::ifstream classFileStream("class.json");
-  if (!classFileStream.is_open()) {
-    throw std::runtime_error("Error: Fides commitmentGenerator cannot open class.json for reading proposes.\n");
+  JsonLoader classJsonData;
+  if (!classJsonData.loadFile("class.json")) {
+    throw std::runtime_error("Error: Fides commitmentGenerator cannot read class.json for reading proposes.\n");
   }
-  nlohmann::json classJsonData;
-  classFileStream >> classJsonData;
-  classFileStream.close();
   string class_value = to_string(Class); // Convert integer to string class
-  n_g = classJsonData[class_value]["n_g"].get<uint64_t>();
-  n_i = classJsonData[class_value]["n_i"].get<uint64_t>();
-  n   = classJsonData[class_value]["n"].get<uint64_t>();
-  m   = classJsonData[class_value]["m"].get<uint64_t>();
-  p   = classJsonData[class_value]["p"].get<uint64_t>();
-  g   = classJsonData[class_value]["g"].get<uint64_t>();
+  n_g = classJsonData.number("/" + class_value + "/n_g");
+  n_i = classJsonData.number("/" + class_value + "/n_i");
+  n   = classJsonData.number("/" + class_value + "/n");
+  m   = classJsonData.number("/" + class_value + "/m");
+  p   = classJsonData.number("/" + class_value + "/p");
+  g   = classJsonData.number("/" + class_value + "/g");
 
   return {startLine, endLine};
 }
@@ -220,6 +220,21 @@ void modifyAndSaveAssembly(const std::string &assemblyFilePath, const std::strin
 
 
     else if (currentLineNumber == endLine + 1){
+      // The program continues after the witness is handed off, so the registers and flags the copy below and
+      // the call clobber are saved on the stack and restored after the call: x0-x18 and x30, NZCV and FPSR, and
+      // all of q0-q31, since C++ code may use any caller-saved SIMD register and only the low halves of v8-v15
+      // are preserved across calls
+      for (int i = 0; i < 18; i += 2) {
+        newAssemblyFileStream << "stp x" << i << ", x" << i + 1 << ", [sp, #-16]!" << endl;
+      }
+      newAssemblyFileStream << "stp x18, x30, [sp, #-16]!" << endl;
+      newAssemblyFileStream << "mrs x9, nzcv" << endl;
+      newAssemblyFileStream << "mrs x10, fpsr" << endl;
+      newAssemblyFileStream << "stp x9, x10, [sp, #-16]!" << endl;
+      for (int i = 0; i < 32; i += 2) {
+        newAssemblyFileStream << "stp q" << i << ", q" << i + 1 << ", [sp, #-32]!" << endl;
+      }
+
       newAssemblyFileStream << "ldr x9, =z_array" << endl;
       newAssemblyFileStream << "mov x10, #1" << endl;
       newAssemblyFileStream << "str x10, [x9]" << endl;
@@ -264,7 +279,18 @@ void modifyAndSaveAssembly(const std::string &assemblyFilePath, const std::strin
         }
       }
 
-      newAssemblyFileStream << "bl proofGenerator\n";
+      // submitWitness snapshots z_array for a prover thread or proverDaemon and returns, instead of proving here
+      newAssemblyFileStream << "bl submitWitness\n";
+      for (int i = 30; i >= 0; i -= 2) {
+        newAssemblyFileStream << "ldp q" << i << ", q" << i + 1 << ", [sp], #32" << endl;
+      }
+      newAssemblyFileStream << "ldp x9, x10, [sp], #16" << endl;
+      newAssemblyFileStream << "msr nzcv, x9" << endl;
+      newAssemblyFileStream << "msr fpsr, x10" << endl;
+      newAssemblyFileStream << "ldp x18, x30, [sp], #16" << endl;
+      for (int i = 16; i >= 0; i -= 2) {
+        newAssemblyFileStream << "ldp x" << i << ", x" << i + 1 << ", [sp], #16" << endl;
+      }
       newAssemblyFileStream << line << std::endl;
     }
     else {
@@ -323,15 +349,12 @@ void commitmentGenerator() {
   setupFilePath = "data/setup";
   setupFilePath += to_string(Class);
   setupFilePath += ".json";
-  std::ifstream setupFileStream(setupFilePath);
-  if (!setupFileStream.is_open()) {
-    throw std::runtime_error("Error: Fides commitmentGenerator cannot open " + setupFilePath + " for reading proposes.\n");
+  JsonLoader setupJsonData;
+  if (!setupJsonData.loadFile(setupFilePath)) {
+    throw std::runtime_error("Error: Fides commitmentGenerator cannot read " + setupFilePath + " for reading proposes.\n");
   }
-  nlohmann::json setupJsonData;
-  setupFileStream >> setupJsonData;
-  setupFileStream.close();
-  vector<uint64_t> ck = setupJsonData["ck"].get<vector<uint64_t>>();
-  uint64_t vk = setupJsonData["vk"].get<uint64_t>();
+  vector<uint64_t> ck = setupJsonData.take("/ck");
+  uint64_t vk = setupJsonData.number("/vk");
 
   
 
@@ -346,14 +369,14 @@ void commitmentGenerator() {
     rightStr = Polynomial::trim(rightStr);
     leftStr = Polynomial::removeCommas(leftStr);
     rightStr = Polynomial::removeCommas(rightStr);
-    cout << "opcode: " << opcode << "\tleftStr: " << leftStr << "\trightStr: " << rightStr << "\n";
+    FIDES_LOG_DEBUG(cout << "opcode: " << opcode << "\tleftStr: " << leftStr << "\trightStr: " << rightStr << "\n");
   }
-  cout << "Number of immediate instructions (n_i): " << n_i << endl;
-  cout << "Number of general instructions (n_g): " << n_g << endl;
+  FIDES_LOG_INFO(cout << "Number of immediate instructions (n_i): " << n_i << endl);
+  FIDES_LOG_INFO(cout << "Number of general instructions (n_g): " << n_g << endl);
 
   // Matrix order
   uint64_t t;
-  cout << "Matrix order: " << n << endl;
+  FIDES_LOG_INFO(cout << "Matrix order: " << n << endl);
 
   t = n_i + 1;
   // m = (((Polynomial::power(n, 2, p) - n) / 2) - ((Polynomial::power(t, 2, p) - t) / 2)) % p;
@@ -509,9 +532,9 @@ void commitmentGenerator() {
     }
   }
 
-  Polynomial::printMatrix(A, "A");
-  Polynomial::printMatrix(B, "B");
-  Polynomial::printMatrix(C, "C");
+  FIDES_LOG_DEBUG(Polynomial::printMatrix(A, "A"));
+  FIDES_LOG_DEBUG(Polynomial::printMatrix(B, "B"));
+  FIDES_LOG_DEBUG(Polynomial::printMatrix(C, "C"));
 
   // Vector H to store powers of w
   vector<uint64_t> H;
@@ -523,11 +546,13 @@ void commitmentGenerator() {
   for (uint64_t i = 1; i < n; i++) {
     H.push_back(Polynomial::power(w, i, p));
   }
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
   cout << "H[n]: ";
   for (uint64_t i = 0; i < n; i++) {
     cout << H[i] << " ";
   }
   cout << endl;
+#endif
 
   uint64_t y, g_m;
 
@@ -539,51 +564,53 @@ void commitmentGenerator() {
   for (uint64_t i = 1; i < m; i++) {
     K.push_back(Polynomial::power(y, i, p));
   }
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
   cout << "K[m]: ";
   for (uint64_t i = 0; i < m; i++) {
     cout << K[i] << " ";
   }
   cout << endl;
+#endif
   
   // Create a polynomial vector vH_x of size (n + 1) initialized to 0
   vector<uint64_t> vH_x(n + 1, 0);
   vH_x[0] = p - 1;
   vH_x[n] = 1;
-  Polynomial::printPolynomial(vH_x, "vH(x)");
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(vH_x, "vH(x)"));
 
  // Create a mapping for the non-zero rows using parameters K and H
   vector<vector<uint64_t>> nonZeroRowsA = Polynomial::getNonZeroRows(A);
   vector<vector<uint64_t>> rowA = Polynomial::createMapping(K, H, nonZeroRowsA);
   
-  Polynomial::printMapping(rowA, "row_A");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(rowA, "row_A"));
   vector<vector<uint64_t>> nonZeroColsA = Polynomial::getNonZeroCols(A);
   vector<vector<uint64_t>> colA = Polynomial::createMapping(K, H, nonZeroColsA);
   
-  Polynomial::printMapping(colA, "col_A");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(colA, "col_A"));
   vector<vector<uint64_t>> valA = Polynomial::valMapping(K, H, nonZeroRowsA, nonZeroColsA, p);
-  Polynomial::printMapping(valA, "val_A");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(valA, "val_A"));
 
   vector<vector<uint64_t>> nonZeroRowsB = Polynomial::getNonZeroRows(B);
   vector<vector<uint64_t>> rowB = Polynomial::createMapping(K, H, nonZeroRowsB);
   
-  Polynomial::printMapping(rowB, "row_B");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(rowB, "row_B"));
   vector<vector<uint64_t>> nonZeroColsB = Polynomial::getNonZeroCols(B);
   vector<vector<uint64_t>> colB = Polynomial::createMapping(K, H, nonZeroColsB);
   
-  Polynomial::printMapping(colB, "col_B");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(colB, "col_B"));
   vector<vector<uint64_t>> valB = Polynomial::valMapping(K, H, nonZeroRowsB, nonZeroColsB, p);
-  Polynomial::printMapping(valB, "val_B");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(valB, "val_B"));
 
   vector<vector<uint64_t>> nonZeroRowsC = Polynomial::getNonZeroRows(C);
   vector<vector<uint64_t>> rowC = Polynomial::createMapping(K, H, nonZeroRowsC);
   
-  Polynomial::printMapping(rowC, "row_C");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(rowC, "row_C"));
   vector<vector<uint64_t>> nonZeroColsC = Polynomial::getNonZeroCols(C);
   vector<vector<uint64_t>> colC = Polynomial::createMapping(K, H, nonZeroColsC);
   
-  Polynomial::printMapping(colC, "col_C");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(colC, "col_C"));
   vector<vector<uint64_t>> valC = Polynomial::valMapping(K, H, nonZeroRowsC, nonZeroColsC, p);
-  Polynomial::printMapping(valC, "val_C");
+  FIDES_LOG_DEBUG(Polynomial::printMapping(valC, "val_C"));
 
 
   vector<uint64_t> rowA_x = Polynomial::setupNewtonPolynomial(rowA[0], rowA[1], p, "rowA(x)");
@@ -612,6 +639,7 @@ void commitmentGenerator() {
   O_AHP.insert(O_AHP.end(), colC_x.begin(), colC_x.end());
   O_AHP.insert(O_AHP.end(), valC_x.begin(), valC_x.end());
 
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
   cout << "O_AHP = {";
   for (uint64_t i = 0; i < O_AHP.size(); i++) {
     cout << O_AHP[i];
@@ -620,6 +648,7 @@ void commitmentGenerator() {
     }
   }
   cout << "}" << endl;
+#endif
 
   uint64_t Com0_AHP = 0, Com1_AHP = 0, Com2_AHP = 0, Com3_AHP = 0, Com4_AHP = 0, Com5_AHP = 0, Com6_AHP = 0, Com7_AHP = 0, Com8_AHP = 0;
 
@@ -646,19 +675,18 @@ void commitmentGenerator() {
     Com7_AHP %= p;
     Com8_AHP %= p;
   }
-  cout << "Com0_AHP = " << Com0_AHP << endl;
-  cout << "Com1_AHP = " << Com1_AHP << endl;
-  cout << "Com2_AHP = " << Com2_AHP << endl;
-  cout << "Com3_AHP = " << Com3_AHP << endl;
-  cout << "Com4_AHP = " << Com4_AHP << endl;
-  cout << "Com5_AHP = " << Com5_AHP << endl;
-  cout << "Com6_AHP = " << Com6_AHP << endl;
-  cout << "Com7_AHP = " << Com7_AHP << endl;
-  cout << "Com8_AHP = " << Com8_AHP << endl;
-
-// Getting the current timestamp as a string
-  auto now = std::chrono::system_clock::now();
-  auto in_time_t = std::chrono::system_clock::to_time_t(now);
+  FIDES_LOG_INFO(cout << "Com0_AHP = " << Com0_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com1_AHP = " << Com1_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com2_AHP = " << Com2_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com3_AHP = " << Com3_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com4_AHP = " << Com4_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com5_AHP = " << Com5_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com6_AHP = " << Com6_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com7_AHP = " << Com7_AHP << endl);
+  FIDES_LOG_INFO(cout << "Com8_AHP = " << Com8_AHP << endl);
+
+// Getting the current timestamp as a string (the seed when FIDESINNOVA_SEED is set)
+  auto in_time_t = FidesRandom::now();
   // std::cout << "in_time_t: " << in_time_t << std::endl;
 
   // Concatenate the strings
@@ -710,7 +738,7 @@ void commitmentGenerator() {
   if (commitmentFile.is_open()) {
       commitmentFile << commitmentString;
       commitmentFile.close();
-      std::cout << commitmentFileName << " is created successfully\n";
+      FIDES_LOG_INFO(std::cout << commitmentFileName << " is created successfully\n");
   } else {
     throw std::runtime_error("Error: Fides commitmentGenerator cannot open " + commitmentFileName + " for writing proposes.\n");\
   }
@@ -733,6 +761,8 @@ void commitmentGenerator() {
   program_param["rC"] = rowC[1];
   program_param["cC"] = colC[1];
   program_param["vC"] = valC[1];
+  // Assembly line of the first gate, so a witness that breaks a gate can be traced to its instruction
+  program_param["line"] = codeBlockStart;
 
 
   // Serialize JSON object to a string
@@ -742,7 +772,7 @@ void commitmentGenerator() {
   if (program_paramFile.is_open()) {
       program_paramFile << program_paramString;
       program_paramFile.close();
-      std::cout << paramFileName << " is created successfully\n";
+      FIDES_LOG_INFO(std::cout << paramFileName << " is created successfully\n");
   } else {
     throw std::runtime_error("Error: Fides commitmentGenerator cannot open " + paramFileName + " for writing proposes.\n");
   }
@@ -780,11 +810,20 @@ int main(int argc, char* argv[]) {
     );
   }
     
-  cout << "startLine: " << startLine << endl;
-  cout << "endLine: " << endLine << endl;
+  FIDES_LOG_DEBUG(cout << "startLine: " << startLine << endl);
+  FIDES_LOG_DEBUG(cout << "endLine: " << endLine << endl);
   
   modifyAndSaveAssembly(assemblyFilePath, newAssemblyFile, startLine, endLine);
+  codeBlockStart = startLine;
   commitmentGenerator();
-  cout << newAssemblyFile << " is created successfully\n";
+
+  // The program sends its witness with the commitment id and the size of z_array, so a prover elsewhere needs no
+  // files from the device
+  std::ofstream newAssemblyFileStream(newAssemblyFile, std::ios::app);
+  newAssemblyFileStream << "\n.section .rodata\n.align 3\n";
+  newAssemblyFileStream << ".global fides_z_array_size\nfides_z_array_size:    .quad " << (n_i + n_g + 1) << "\n";
+  newAssemblyFileStream << ".global fides_commitment_id\nfides_commitment_id:    .asciz \"" << commitmentID << "\"\n";
+  newAssemblyFileStream.close();
+  FIDES_LOG_INFO(cout << newAssemblyFile << " is created successfully\n");
   return 0;
 }
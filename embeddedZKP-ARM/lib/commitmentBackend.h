@@ -0,0 +1,522 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef COMMITMENTBACKEND_H
+#define COMMITMENTBACKEND_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include "polynomial.h"
+#ifdef FIDES_KZG_MCL
+#include <mcl/bn256.hpp>
+#endif
+
+using namespace std;
+
+// Polynomial commitment schemes the AHP polynomials can be committed with. Every backend commits to a polynomial
+// given by its coefficients in p, opens several polynomials at one point with a single proof for their sum weighted
+// with weights (as p(x) weights its terms with eta), and verifies such an opening against the commitments.
+// Commitments, values and proofs are opaque byte strings in the encoding of the backend. The prover and verifier
+// use the backend FIDESINNOVA_COMMITMENT_BACKEND names; their proof formats carry each element as one value in p.
+//  - "modp": the scheme of the current setup, a commitment is sum ck_i a_i in p and the pairing is e_func. Fast,
+//    but ck reveals tau, so it is not binding.
+//  - "bn254": KZG over the BN254 curve with Herumi mcl; build with -DFIDES_KZG_MCL -lmcl. Coefficients are lifted
+//    into the scalar field of the curve, so a proof needs the AHP to run in that field before it can use it. Its
+//    setup comes from one party, so it is for benchmarks only and not secure (see Bn254CommitmentBackend).
+// Header only, so the prover, the verifier and the benchmark link it without extra sources.
+class CommitmentBackend {
+public:
+  typedef vector<uint8_t> Element;
+
+  // The values of the opened polynomials at the point and one proof for their weighted sum
+  struct Opening {
+    vector<Element> values;
+    Element proof;
+  };
+
+  virtual ~CommitmentBackend() {}
+
+  // Function to get the name create takes
+  virtual std::string name() const = 0;
+
+  // Function to get the number of coefficients the setup can commit to
+  virtual size_t maxSize() const = 0;
+
+  // Function to commit to a polynomial
+  virtual Element commit(const vector<uint64_t>& poly) const = 0;
+
+  // Function to open polys at point with one proof for sum weights_i polys_i
+  virtual Opening open(const vector<const vector<uint64_t>*>& polys, const vector<uint64_t>& weights, uint64_t point) const = 0;
+
+  // Function to verify an opening of the polynomials of commitments, weighted with the weights it was opened with
+  virtual bool verify(const vector<Element>& commitments, const vector<uint64_t>& weights, uint64_t point, const Opening& opening) const = 0;
+
+  // Function to commit to a polynomial that divides others, in the form verifyDivision takes its divisor in
+  virtual Element commitDivisor(const vector<uint64_t>& poly) const {
+    return commit(poly);
+  }
+
+  // Function to verify that the polynomial of commitment is the one of quotient times the one of divisor, as an
+  // opening at several points is checked. divisor is committed with commitDivisor
+  virtual bool verifyDivision(const Element&, const Element&, const Element&) const {
+    throw std::runtime_error("Error: Fides commitment backend " + name() + " cannot verify a division");
+  }
+
+  // Function to tell whether every element is one value in p, the form the proof formats carry
+  virtual bool valuesInP() const {
+    return false;
+  }
+
+  // Function to get an element as the value in p a proof carries
+  virtual uint64_t value(const Element&) const {
+    throw std::runtime_error("Error: Fides commitment backend " + name() + " has no elements in p");
+  }
+
+  // Function to get the element of a value in p read from a proof
+  virtual Element element(uint64_t) const {
+    throw std::runtime_error("Error: Fides commitment backend " + name() + " has no elements in p");
+  }
+
+  // Function to create the backend called name for the setup of a class: its ck, vk, generator g and prime p
+  static unique_ptr<CommitmentBackend> create(const std::string& name, const vector<uint64_t>& ck, uint64_t vk, uint64_t g, uint64_t p);
+
+  // Function to create the backend called name for the prover or verifier of a class, which needs its elements
+  // in p
+  static shared_ptr<const CommitmentBackend> createForProofs(const std::string& name, const vector<uint64_t>& ck, uint64_t vk, uint64_t g, uint64_t p) {
+    shared_ptr<const CommitmentBackend> backend = create(name, ck, vk, g, p);
+    if (!backend->valuesInP()) {
+      throw std::runtime_error("Error: Fides proofs carry commitments as values in p, which backend " + name + " does not produce; use it with commitmentBench");
+    }
+    return backend;
+  }
+
+  // Function to read FIDESINNOVA_COMMITMENT_BACKEND: modp (default) or bn254
+  static std::string nameFromEnv() {
+    const char* name = getenv("FIDESINNOVA_COMMITMENT_BACKEND");
+    return name != nullptr ? name : "modp";
+  }
+
+  // Function to list the backends this build supports
+  static vector<std::string> available() {
+#ifdef FIDES_KZG_MCL
+    return { "modp", "bn254" };
+#else
+    return { "modp" };
+#endif
+  }
+};
+
+// The commitment scheme of the current setup
+class ModPCommitmentBackend : public CommitmentBackend {
+public:
+  ModPCommitmentBackend(const vector<uint64_t>& ck, uint64_t vk, uint64_t g, uint64_t p) : ck(ck), vk(vk), g(g), p(p) {}
+
+  std::string name() const override {
+    return "modp";
+  }
+
+  size_t maxSize() const override {
+    return ck.size();
+  }
+
+  Element commit(const vector<uint64_t>& poly) const override {
+    return encode(Polynomial::KZG_Commitment(ck, poly, p));
+  }
+
+  Opening open(const vector<const vector<uint64_t>*>& polys, const vector<uint64_t>& weights, uint64_t point) const override {
+    Opening opening;
+    vector<uint64_t> sum;
+    for (size_t i = 0; i < polys.size(); i++) {
+      opening.values.push_back(encode(Polynomial::evaluatePolynomial(*polys[i], point, p)));
+      sum = Polynomial::addPolynomials(sum, Polynomial::multiplyPolynomialByNumber(*polys[i], weights[i] % p, p), p);
+    }
+    opening.proof = encode(Polynomial::KZG_Commitment(ck, Polynomial::dividePolynomialByLinear(sum, point % p, p)[0], p));
+    return opening;
+  }
+
+  // e(C - g y, g) = e(W, vk - g z) with C and y the weighted sums of the commitments and values, as in eq5
+  bool verify(const vector<Element>& commitments, const vector<uint64_t>& weights, uint64_t point, const Opening& opening) const override {
+    if (commitments.size() != weights.size() || opening.values.size() != weights.size()) {
+      return false;
+    }
+    uint64_t C = 0, y = 0;
+    for (size_t i = 0; i < weights.size(); i++) {
+      C = (C + (weights[i] % p) * decode(commitments[i])) % p;
+      y = (y + (weights[i] % p) * decode(opening.values[i])) % p;
+    }
+    uint64_t left = Polynomial::subtractModP(C, (g * y) % p, p);
+    uint64_t right = Polynomial::subtractModP(vk, (g * (point % p)) % p, p);
+    return Polynomial::e_func(left, g, g, p) == Polynomial::e_func(decode(opening.proof), right, g, p);
+  }
+
+  // e(C, g) = e(W, D)
+  bool verifyDivision(const Element& commitment, const Element& quotient, const Element& divisor) const override {
+    return Polynomial::e_func(decode(commitment), g, g, p) == Polynomial::e_func(decode(quotient), decode(divisor), g, p);
+  }
+
+  bool valuesInP() const override {
+    return true;
+  }
+
+  uint64_t value(const Element& element) const override {
+    return decode(element);
+  }
+
+  Element element(uint64_t value) const override {
+    return encode(value);
+  }
+
+private:
+  vector<uint64_t> ck;
+  uint64_t vk, g, p;
+
+  static Element encode(uint64_t value) {
+    Element bytes(sizeof(value));
+    memcpy(bytes.data(), &value, sizeof(value));
+    return bytes;
+  }
+
+  static uint64_t decode(const Element& bytes) {
+    if (bytes.size() != sizeof(uint64_t)) {
+      throw std::runtime_error("Error: Fides mod p commitment element has " + to_string(bytes.size()) + " bytes");
+    }
+    uint64_t value;
+    memcpy(&value, bytes.data(), sizeof(value));
+    return value;
+  }
+};
+
+#ifdef FIDES_KZG_MCL
+// KZG over BN254. The setup holds [tau^i]G1 for i < size and [tau^i]G2 for i < DIVISOR_SIZE. Commitments and proofs
+// are multi-scalar multiplications over the setup, and an opening of several polynomials is one proof for their
+// weighted sum, checked with one product of two Miller loops and one final exponentiation.
+// BENCHMARK ONLY, NOT SECURE: tau is drawn from the CSPRNG of mcl and cleared once the powers are built, but by one
+// party and with no ceremony, so whoever builds the setup, or the setup file of FIDESINNOVA_BN254_SETUP, may have kept
+// tau and can open a commitment to any value
+class Bn254CommitmentBackend : public CommitmentBackend {
+public:
+  typedef mcl::bn::Fr Fr;
+  typedef mcl::bn::G1 G1;
+  typedef mcl::bn::G2 G2;
+
+  // Number of [tau^i]G2, enough for the divisors of the succinct openings of s(x)
+  static constexpr size_t DIVISOR_SIZE = 64;
+
+  // The setup is read from setupPath when that file exists, and must hold at least size powers in G1. Otherwise it
+  // is built from a random tau, and written to setupPath unless it is empty, so a prover and a verifier in other
+  // processes can share it
+  Bn254CommitmentBackend(size_t size, const std::string& setupPath) {
+    static std::once_flag initialized;
+    std::call_once(initialized, [] { mcl::bn::initPairing(); });
+
+    if (!setupPath.empty() && std::ifstream(setupPath, std::ios::binary).good()) {
+      load(setupPath, size);
+    } else {
+      generate(size);
+      if (!setupPath.empty()) {
+        save(setupPath);
+      }
+    }
+    g1 = g1Powers[0];
+    g2 = g2Powers[0];
+    g2Tau = g2Powers[1];
+  }
+
+  // Function to read FIDESINNOVA_BN254_SETUP, the file of the setup; empty without it, for a setup of this process only
+  static std::string setupPathFromEnv() {
+    const char* path = getenv("FIDESINNOVA_BN254_SETUP");
+    return path != nullptr ? path : "";
+  }
+
+  std::string name() const override {
+    return "bn254";
+  }
+
+  size_t maxSize() const override {
+    return g1Powers.size();
+  }
+
+  Element commit(const vector<uint64_t>& poly) const override {
+    vector<Fr> coefficients(poly.size());
+    for (size_t i = 0; i < poly.size(); i++) {
+      coefficients[i] = lift(poly[i]);
+    }
+    return encode(msm(coefficients));
+  }
+
+  Opening open(const vector<const vector<uint64_t>*>& polys, const vector<uint64_t>& weights, uint64_t point) const override {
+    Opening opening;
+    Fr z = lift(point);
+    vector<Fr> sum;
+    for (size_t i = 0; i < polys.size(); i++) {
+      const vector<uint64_t>& poly = *polys[i];
+      Fr value = 0, weight = lift(weights[i]);
+      if (sum.size() < poly.size()) {
+        sum.resize(poly.size(), Fr(0));
+      }
+      for (size_t j = poly.size(); j-- > 0;) {
+        Fr coefficient = lift(poly[j]);
+        value *= z;
+        value += coefficient;
+        sum[j] += coefficient * weight;
+      }
+      opening.values.push_back(encode(value));
+    }
+
+    // Synthetic division of the weighted sum by (x - z)
+    vector<Fr> quotient(sum.empty() ? 0 : sum.size() - 1);
+    Fr carry = sum.empty() ? Fr(0) : sum.back();
+    for (size_t i = quotient.size(); i > 0; i--) {
+      quotient[i - 1] = carry;
+      carry = sum[i - 1] + carry * z;
+    }
+    opening.proof = encode(msm(quotient));
+    return opening;
+  }
+
+  // e(C - [y]G1 + [z]W, [1]G2) = e(W, [tau]G2) with C and y the weighted sums of the commitments and values,
+  // checked as e(C - [y]G1 + [z]W, [1]G2) e(-W, [tau]G2) = 1
+  bool verify(const vector<Element>& commitments, const vector<uint64_t>& weights, uint64_t point, const Opening& opening) const override {
+    if (commitments.size() != weights.size() || opening.values.size() != weights.size()) {
+      return false;
+    }
+    vector<G1> points(commitments.size());
+    vector<Fr> scalars(weights.size());
+    Fr y = 0;
+    for (size_t i = 0; i < weights.size(); i++) {
+      points[i] = decode<G1>(commitments[i]);
+      scalars[i] = lift(weights[i]);
+      y += scalars[i] * decode<Fr>(opening.values[i]);
+    }
+    G1 C, yG1, zW, W = decode<G1>(opening.proof);
+    G1::mulVec(C, points.data(), scalars.data(), points.size());
+    G1::mul(yG1, g1, y);
+    G1::mul(zW, W, lift(point));
+    G1 P[2];
+    G1::sub(P[0], C, yG1);
+    G1::add(P[0], P[0], zW);
+    G1::neg(P[1], W);
+    G2 Q[2] = { g2, g2Tau };
+    return pairingProductIsOne(P, Q);
+  }
+
+  // The divisor is committed in G2, as [D(tau)]G2
+  Element commitDivisor(const vector<uint64_t>& poly) const override {
+    if (poly.size() > g2Powers.size()) {
+      throw std::runtime_error("Error: Fides divisor of " + to_string(poly.size()) + " coefficients exceeds the BN254 setup of " + to_string(g2Powers.size()));
+    }
+    vector<Fr> coefficients(poly.size());
+    for (size_t i = 0; i < poly.size(); i++) {
+      coefficients[i] = lift(poly[i]);
+    }
+    G2 result;
+    result.clear();
+    if (!coefficients.empty()) {
+      G2::mulVec(result, g2Powers.data(), coefficients.data(), coefficients.size());
+    }
+    return encode(result);
+  }
+
+  // e(C, [1]G2) = e(W, [D(tau)]G2), checked as e(C, [1]G2) e(-W, [D(tau)]G2) = 1
+  bool verifyDivision(const Element& commitment, const Element& quotient, const Element& divisor) const override {
+    G1 P[2];
+    P[0] = decode<G1>(commitment);
+    G1::neg(P[1], decode<G1>(quotient));
+    G2 Q[2] = { g2, decode<G2>(divisor) };
+    return pairingProductIsOne(P, Q);
+  }
+
+private:
+  static constexpr uint64_t SETUP_MAGIC = 0x3135324e42534446ULL;  // "FDSBN251"
+
+  // mulVec may normalize its bases in place; the powers are normalized when the setup is built, so it leaves them
+  // as they are and concurrent commitments only read them
+  mutable vector<G1> g1Powers;
+  mutable vector<G2> g2Powers;
+  G1 g1;
+  G2 g2, g2Tau;
+
+  // Function to build the powers of a random tau, which is cleared before it returns
+  void generate(size_t size) {
+    Fr tau;
+    tau.setByCSPRNG();
+    G1 generator1;
+    G2 generator2;
+    mcl::bn::mapToG1(generator1, 1);
+    mcl::bn::mapToG2(generator2, 1);
+
+    // [tau^i]G1 in parallel chunks, each starting from its own power of tau, then normalized once so the
+    // multi-scalar multiplications read affine points
+    g1Powers.resize(max<size_t>(size, 2));
+    unsigned threads = max(1u, std::thread::hardware_concurrency());
+    size_t chunk = (g1Powers.size() + threads - 1) / threads;
+    vector<std::thread> workers;
+    for (size_t begin = 0; begin < g1Powers.size(); begin += chunk) {
+      workers.emplace_back([&, begin] {
+        Fr power;
+        Fr::pow(power, tau, begin);
+        for (size_t i = begin; i < min(g1Powers.size(), begin + chunk); i++) {
+          G1::mul(g1Powers[i], generator1, power);
+          power *= tau;
+        }
+        power.clear();
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    G1::normalizeVec(g1Powers.data(), g1Powers.data(), g1Powers.size());
+
+    g2Powers.resize(DIVISOR_SIZE);
+    Fr power = 1;
+    for (G2& element : g2Powers) {
+      G2::mul(element, generator2, power);
+      power *= tau;
+    }
+    G2::normalizeVec(g2Powers.data(), g2Powers.data(), g2Powers.size());
+    power.clear();
+    tau.clear();
+  }
+
+  // Function to write the setup: the magic, the numbers of powers in G1 and G2, then every power as its length in
+  // one byte and its serialization
+  void save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    uint64_t header[3] = { SETUP_MAGIC, g1Powers.size(), g2Powers.size() };
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const G1& element : g1Powers) {
+      writeElement(file, encode(element));
+    }
+    for (const G2& element : g2Powers) {
+      writeElement(file, encode(element));
+    }
+    if (!file) {
+      throw std::runtime_error("Error: Fides cannot write the BN254 setup " + path);
+    }
+  }
+
+  // Function to read the first size powers in G1 and the powers in G2 of the setup save wrote
+  void load(const std::string& path, size_t size) {
+    std::ifstream file(path, std::ios::binary);
+    uint64_t header[3] = { 0, 0, 0 };
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || header[0] != SETUP_MAGIC || header[1] < 2 || header[2] != DIVISOR_SIZE) {
+      throw std::runtime_error("Error: Fides " + path + " is not a BN254 setup");
+    }
+    if (header[1] < size) {
+      throw std::runtime_error("Error: Fides BN254 setup " + path + " has " + to_string(header[1]) + " powers, the class needs " + to_string(size) + "; build it with the largest class first");
+    }
+    g1Powers.resize(max<size_t>(size, 2));
+    for (size_t i = 0; i < header[1]; i++) {
+      Element bytes = readElement(file, path);
+      if (i < g1Powers.size()) {
+        g1Powers[i] = decode<G1>(bytes);
+      }
+    }
+    g2Powers.resize(DIVISOR_SIZE);
+    for (G2& element : g2Powers) {
+      element = decode<G2>(readElement(file, path));
+    }
+    G1::normalizeVec(g1Powers.data(), g1Powers.data(), g1Powers.size());
+    G2::normalizeVec(g2Powers.data(), g2Powers.data(), g2Powers.size());
+  }
+
+  static void writeElement(std::ofstream& file, const Element& bytes) {
+    uint8_t length = static_cast<uint8_t>(bytes.size());
+    file.write(reinterpret_cast<const char*>(&length), 1);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+
+  static Element readElement(std::ifstream& file, const std::string& path) {
+    uint8_t length = 0;
+    file.read(reinterpret_cast<char*>(&length), 1);
+    Element bytes(length);
+    file.read(reinterpret_cast<char*>(bytes.data()), length);
+    if (!file) {
+      throw std::runtime_error("Error: Fides BN254 setup " + path + " is truncated");
+    }
+    return bytes;
+  }
+
+  static bool pairingProductIsOne(const G1* P, const G2* Q) {
+    mcl::bn::Fp12 product;
+    mcl::bn::millerLoopVec(product, P, Q, 2);
+    mcl::bn::finalExp(product, product);
+    return product.isOne();
+  }
+
+  static Fr lift(uint64_t value) {
+    Fr x;
+    x.setArray(&value, 1);
+    return x;
+  }
+
+  G1 msm(const vector<Fr>& scalars) const {
+    if (scalars.size() > g1Powers.size()) {
+      throw std::runtime_error("Error: Fides polynomial of " + to_string(scalars.size()) + " coefficients exceeds the BN254 setup of " + to_string(g1Powers.size()));
+    }
+    G1 result;
+    result.clear();
+    if (!scalars.empty()) {
+      G1::mulVec(result, g1Powers.data(), scalars.data(), scalars.size());
+    }
+    return result;
+  }
+
+  template <class T>
+  static Element encode(const T& value) {
+    Element bytes(128);
+    size_t written = value.serialize(bytes.data(), bytes.size());
+    if (written == 0) {
+      throw std::runtime_error("Error: Fides cannot serialize a BN254 element");
+    }
+    bytes.resize(written);
+    return bytes;
+  }
+
+  template <class T>
+  static T decode(const Element& bytes) {
+    T value;
+    if (bytes.empty() || value.deserialize(bytes.data(), bytes.size()) != bytes.size()) {
+      throw std::runtime_error("Error: Fides invalid BN254 element of " + to_string(bytes.size()) + " bytes");
+    }
+    return value;
+  }
+};
+#endif
+
+inline unique_ptr<CommitmentBackend> CommitmentBackend::create(const std::string& name, const vector<uint64_t>& ck, uint64_t vk, uint64_t g, uint64_t p) {
+  if (name == "modp") {
+    return unique_ptr<CommitmentBackend>(new ModPCommitmentBackend(ck, vk, g, p));
+  }
+  if (name == "bn254") {
+#ifdef FIDES_KZG_MCL
+    return unique_ptr<CommitmentBackend>(new Bn254CommitmentBackend(ck.size(), Bn254CommitmentBackend::setupPathFromEnv()));
+#else
+    throw std::runtime_error("Error: Fides commitment backend bn254 requires a build with -DFIDES_KZG_MCL -lmcl");
+#endif
+  }
+  throw std::runtime_error("Error: Fides unknown commitment backend " + name + "; use modp or bn254");
+}
+
+#endif  // COMMITMENTBACKEND_H
@@ -0,0 +1,50 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FIDESLOG_H
+#define FIDESLOG_H
+
+// Compile-time log levels for the prover, commitmentGenerator and verifier.
+// Statements above FIDES_LOG_LEVEL are removed by the preprocessor, so their arguments are never evaluated.
+// The default prints results only; build with -DFIDES_LOG_LEVEL=3 to print every intermediate polynomial,
+// matrix and mapping, or with -DFIDES_LOG_LEVEL=0 to print nothing.
+#define FIDES_LOG_LEVEL_NONE 0
+#define FIDES_LOG_LEVEL_ERROR 1
+#define FIDES_LOG_LEVEL_INFO 2
+#define FIDES_LOG_LEVEL_DEBUG 3
+
+#ifndef FIDES_LOG_LEVEL
+#define FIDES_LOG_LEVEL FIDES_LOG_LEVEL_INFO
+#endif
+
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_ERROR
+#define FIDES_LOG_ERROR(...) do { __VA_ARGS__; } while (0)
+#else
+#define FIDES_LOG_ERROR(...) do { } while (0)
+#endif
+
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_INFO
+#define FIDES_LOG_INFO(...) do { __VA_ARGS__; } while (0)
+#else
+#define FIDES_LOG_INFO(...) do { } while (0)
+#endif
+
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
+#define FIDES_LOG_DEBUG(...) do { __VA_ARGS__; } while (0)
+#else
+#define FIDES_LOG_DEBUG(...) do { } while (0)
+#endif
+
+#endif  // FIDESLOG_H
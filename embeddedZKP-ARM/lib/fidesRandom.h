@@ -0,0 +1,77 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FIDESRANDOM_H
+#define FIDESRANDOM_H
+
+#include <random>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+
+using namespace std;
+
+// Source of every random value and timestamp of the setup, commitmentGenerator, prover and verifier.
+// Engines are seeded from std::random_device unless FIDESINNOVA_SEED is set. With a seed, the n-th engine a process
+// creates depends only on the seed and n, and the timestamp in the commitment id is the seed. Two runs with the same
+// seed and inputs then write byte-identical setups, commitments and proofs, for benchmarks and regression tests.
+// Never set FIDESINNOVA_SEED in production: the zero-knowledge masks become predictable.
+// Header only, so setup and the verifier link it without extra sources.
+class FidesRandom {
+public:
+  typedef std::mt19937_64 Engine;
+
+  // Function to tell whether FIDESINNOVA_SEED is set
+  static bool deterministic() {
+    return seed() != nullptr;
+  }
+
+  // Function to create an independent engine; a caller that needs reproducible values across threads creates one
+  // per stream in a fixed order and passes it down
+  static Engine engine() {
+    static atomic<uint64_t> streams(0);
+    const uint64_t* fixed = seed();
+    if (fixed == nullptr) {
+      std::random_device rd;
+      std::seed_seq sequence{ rd(), rd(), rd(), rd() };
+      return Engine(sequence);
+    }
+    uint64_t stream = streams++;
+    std::seed_seq sequence{ (uint32_t)*fixed, (uint32_t)(*fixed >> 32), (uint32_t)stream, (uint32_t)(stream >> 32) };
+    return Engine(sequence);
+  }
+
+  // Function to get the engine of the calling thread, created on its first use
+  static Engine& threadEngine() {
+    thread_local Engine threadRng = engine();
+    return threadRng;
+  }
+
+  // Function to get the current time in seconds since the epoch, or the seed when FIDESINNOVA_SEED is set
+  static time_t now() {
+    const uint64_t* fixed = seed();
+    return fixed == nullptr ? time(nullptr) : (time_t)*fixed;
+  }
+
+private:
+  static const uint64_t* seed() {
+    static const uint64_t value = getenv("FIDESINNOVA_SEED") != nullptr ? strtoull(getenv("FIDESINNOVA_SEED"), nullptr, 10) : 0;
+    static const bool isSet = getenv("FIDESINNOVA_SEED") != nullptr;
+    return isSet ? &value : nullptr;
+  }
+};
+
+#endif  // FIDESRANDOM_H
@@ -0,0 +1,131 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FIDESSOCKET_H
+#define FIDESSOCKET_H
+
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Stream sockets of the prover and verifier daemons and their clients. An address is "tcp:host:port" or the path
+// of a Unix domain socket. Header only, so each daemon links it without extra sources.
+class FidesSocket {
+public:
+  // Function to read exactly size bytes from a socket; returns false if the peer closed it first
+  static bool readFully(int fd, void* data, size_t size) {
+    uint8_t* pos = static_cast<uint8_t*>(data);
+    while (size > 0) {
+      ssize_t got = read(fd, pos, size);
+      if (got <= 0) {
+        return false;
+      }
+      pos += got;
+      size -= got;
+    }
+    return true;
+  }
+
+  // Function to write exactly size bytes to a socket; returns false if the peer closed it first
+  static bool writeFully(int fd, const void* data, size_t size) {
+    const uint8_t* pos = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      ssize_t put = send(fd, pos, size, MSG_NOSIGNAL);
+      if (put <= 0) {
+        return false;
+      }
+      pos += put;
+      size -= put;
+    }
+    return true;
+  }
+
+  // Function to open a stream socket for address, "tcp:host:port" or the path of a Unix domain socket (optionally
+  // "unix:path"), and either listen on it or connect it to the server
+  static int open(const std::string& address, bool listening) {
+    if (address.compare(0, 4, "tcp:") == 0) {
+      size_t colon = address.rfind(':');
+      if (colon <= 3) {
+        throw std::runtime_error("Error: Fides address " + address + " has no port");
+      }
+      std::string host = address.substr(4, colon - 4);
+      std::string port = address.substr(colon + 1);
+      addrinfo hints = {};
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      hints.ai_flags = listening ? AI_PASSIVE : 0;
+      addrinfo* results = nullptr;
+      if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &results) != 0) {
+        throw std::runtime_error("Error: Fides cannot resolve " + address);
+      }
+      int fd = -1;
+      for (addrinfo* result = results; result != nullptr; result = result->ai_next) {
+        fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (fd < 0) {
+          continue;
+        }
+        int on = 1;
+        if (listening) {
+          setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+          if (bind(fd, result->ai_addr, result->ai_addrlen) == 0 && listen(fd, 16) == 0) {
+            break;
+          }
+        } else if (connect(fd, result->ai_addr, result->ai_addrlen) == 0) {
+          // Requests and replies are single frames, so they are sent at once
+          setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+          break;
+        }
+        close(fd);
+        fd = -1;
+      }
+      freeaddrinfo(results);
+      if (fd < 0) {
+        throw std::runtime_error(std::string("Error: Fides cannot ") + (listening ? "listen on " : "connect to ") + address);
+      }
+      return fd;
+    }
+
+    std::string path = address.compare(0, 5, "unix:") == 0 ? address.substr(5) : address;
+    sockaddr_un unixAddress = {};
+    if (path.size() >= sizeof(unixAddress.sun_path)) {
+      throw std::runtime_error("Error: Fides socket path " + path + " is too long");
+    }
+    unixAddress.sun_family = AF_UNIX;
+    path.copy(unixAddress.sun_path, path.size());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && listening) {
+      unlink(path.c_str());
+      if (bind(fd, (sockaddr*)&unixAddress, sizeof(unixAddress)) == 0 && listen(fd, 16) == 0) {
+        return fd;
+      }
+    } else if (fd >= 0 && connect(fd, (sockaddr*)&unixAddress, sizeof(unixAddress)) == 0) {
+      return fd;
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::runtime_error(std::string("Error: Fides cannot ") + (listening ? "listen on " : "connect to ") + path);
+  }
+};
+
+#endif  // FIDESSOCKET_H
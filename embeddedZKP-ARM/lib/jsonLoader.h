@@ -0,0 +1,370 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef JSONLOADER_H
+#define JSONLOADER_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include "json.hpp"
+
+using namespace std;
+
+// Streaming loader for the JSON artifacts (commitment, param, class, setup and proof files).
+// Numbers are parsed through the SAX interface of json.hpp straight into one vector<uint64_t> per array, so no
+// DOM is built and take() moves the vectors out without a copy. Values are addressed by their JSON pointer,
+// e.g. "/ck", "/1/n_g" or "/B/0" for the first row of an array of arrays.
+// Header only, so the prover, commitmentGenerator and verifier link it without extra sources.
+class JsonLoader : public nlohmann::json_sax<nlohmann::json> {
+public:
+  // Function to load a file; returns false if it cannot be opened or is not valid JSON
+  bool loadFile(const std::string& path) {
+    std::ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+    std::string text;
+    file.seekg(0, ios::end);
+    text.resize(file.tellg());
+    file.seekg(0, ios::beg);
+    file.read(&text[0], text.size());
+    return loadString(text);
+  }
+
+  // Function to load JSON text; returns false if it is not valid JSON
+  bool loadString(const std::string& text) {
+    clear();
+    if (scan(text)) {
+      return true;
+    }
+    // Escaped strings, signed or fractional numbers and malformed text go through the json.hpp lexer
+    clear();
+    return nlohmann::json::sax_parse(text, this);
+  }
+
+  // Function to check whether a number, array or string exists at path
+  bool has(const std::string& path) const {
+    return scalars.count(path) != 0 || arrays.count(path) != 0 || strings.count(path) != 0;
+  }
+
+  // Function to get the number at path
+  uint64_t number(const std::string& path) const {
+    auto entry = scalars.find(path);
+    if (entry == scalars.end()) {
+      throw std::runtime_error("Error: Fides JSON has no number at " + path);
+    }
+    return entry->second;
+  }
+
+  // Function to get the string at path
+  std::string text(const std::string& path) const {
+    auto entry = strings.find(path);
+    if (entry == strings.end()) {
+      throw std::runtime_error("Error: Fides JSON has no string at " + path);
+    }
+    return entry->second;
+  }
+
+  // Function to move the numbers of the array at path out of the loader
+  vector<uint64_t> take(const std::string& path) {
+    auto entry = arrays.find(path);
+    if (entry == arrays.end()) {
+      throw std::runtime_error("Error: Fides JSON has no array at " + path);
+    }
+    vector<uint64_t> values = std::move(entry->second);
+    arrays.erase(entry);
+    return values;
+  }
+
+  // Function to move the rows of the array of arrays at path out of the loader
+  vector<vector<uint64_t>> takeRows(const std::string& path) {
+    if (arrays.count(path) == 0) {
+      throw std::runtime_error("Error: Fides JSON has no array at " + path);
+    }
+    vector<vector<uint64_t>> rows;
+    while (arrays.count(path + "/" + to_string(rows.size())) != 0) {
+      rows.push_back(take(path + "/" + to_string(rows.size())));
+    }
+    arrays.erase(path);
+    return rows;
+  }
+
+  // SAX events
+  bool null() override {
+    next();
+    return true;
+  }
+
+  bool boolean(bool val) override {
+    store(val ? 1 : 0);
+    return true;
+  }
+
+  bool number_integer(number_integer_t val) override {
+    store((uint64_t)val);
+    return true;
+  }
+
+  bool number_unsigned(number_unsigned_t val) override {
+    store(val);
+    return true;
+  }
+
+  bool number_float(number_float_t val, const string_t& /*unused*/) override {
+    store((uint64_t)val);
+    return true;
+  }
+
+  bool string(string_t& val) override {
+    if (frames.empty() || !frames.back().isArray) {
+      strings[path()] = val;
+    }
+    next();
+    return true;
+  }
+
+  bool binary(binary_t& /*unused*/) override {
+    next();
+    return true;
+  }
+
+  bool start_object(std::size_t /*unused*/) override {
+    current = nullptr;
+    frames.push_back({ path(), false, 0, "" });
+    return true;
+  }
+
+  bool key(string_t& val) override {
+    frames.back().key = val;
+    frames.back().index++;
+    return true;
+  }
+
+  bool end_object() override {
+    frames.pop_back();
+    next();
+    return true;
+  }
+
+  bool start_array(std::size_t /*unused*/) override {
+    std::string arrayPath = path();
+    arrays[arrayPath];
+    current = nullptr;
+    frames.push_back({ arrayPath, true, 0, "" });
+    return true;
+  }
+
+  bool end_array() override {
+    frames.pop_back();
+    next();
+    return true;
+  }
+
+  bool parse_error(std::size_t /*unused*/, const std::string& /*unused*/, const nlohmann::detail::exception& /*unused*/) override {
+    return false;
+  }
+
+private:
+  struct Frame {
+    std::string path;
+    bool isArray;
+    uint64_t index;
+    std::string key;
+  };
+
+  unordered_map<std::string, uint64_t> scalars;
+  unordered_map<std::string, vector<uint64_t>> arrays;
+  unordered_map<std::string, std::string> strings;
+  vector<Frame> frames;
+  // Array that receives the numbers of the innermost frame, cached so elements skip the hash lookup; element
+  // references of an unordered_map stay valid when other arrays are inserted
+  vector<uint64_t>* current = nullptr;
+
+  void clear() {
+    scalars.clear();
+    arrays.clear();
+    strings.clear();
+    frames.clear();
+    current = nullptr;
+  }
+
+  // Function to emit the SAX events of text that only holds unescaped strings and unsigned integers, which is
+  // every artifact the tools write; returns false on anything else
+  bool scan(const std::string& text) {
+    const char* c = text.data();
+    const char* end = c + text.size();
+    bool expectKey = false;
+    bool done = false;
+    while (true) {
+      while (c != end && (*c == ' ' || *c == '\n' || *c == '\r' || *c == '\t')) {
+        c++;
+      }
+      if (c == end) {
+        return done && frames.empty();
+      }
+      if (done) {
+        return false;
+      }
+      if (expectKey) {
+        if (*c == '}' && frames.back().index == 0) {
+          c++;
+          end_object();
+        } else {
+          if (*c != '"') {
+            return false;
+          }
+          const char* close = scanString(c, end);
+          if (close == nullptr) {
+            return false;
+          }
+          std::string name(c + 1, close);
+          key(name);
+          c = close + 1;
+          while (c != end && (*c == ' ' || *c == '\n' || *c == '\r' || *c == '\t')) {
+            c++;
+          }
+          if (c == end || *c != ':') {
+            return false;
+          }
+          c++;
+          expectKey = false;
+          continue;
+        }
+      } else if (*c == '{') {
+        c++;
+        start_object(0);
+        expectKey = true;
+        continue;
+      } else if (*c == '[') {
+        c++;
+        start_array(0);
+        continue;
+      } else if (*c == ']' && !frames.empty() && frames.back().isArray && frames.back().index == 0) {
+        c++;
+        end_array();
+      } else if (*c >= '0' && *c <= '9') {
+        uint64_t value = 0;
+        const char* start = c;
+        while (c != end && *c >= '0' && *c <= '9') {
+          if (value > (UINT64_MAX - 9) / 10) {
+            return false;
+          }
+          value = value * 10 + (*c - '0');
+          c++;
+        }
+        if ((*start == '0' && c - start > 1) || (c != end && (*c == '.' || *c == 'e' || *c == 'E'))) {
+          return false;
+        }
+        store(value);
+      } else if (*c == '"') {
+        const char* close = scanString(c, end);
+        if (close == nullptr) {
+          return false;
+        }
+        std::string value(c + 1, close);
+        string(value);
+        c = close + 1;
+      } else if (text.compare(c - text.data(), 4, "true") == 0) {
+        c += 4;
+        boolean(true);
+      } else if (text.compare(c - text.data(), 5, "false") == 0) {
+        c += 5;
+        boolean(false);
+      } else if (text.compare(c - text.data(), 4, "null") == 0) {
+        c += 4;
+        null();
+      } else {
+        return false;
+      }
+
+      // After a value: a comma, the end of the enclosing container, or the end of the text
+      while (true) {
+        while (c != end && (*c == ' ' || *c == '\n' || *c == '\r' || *c == '\t')) {
+          c++;
+        }
+        if (frames.empty()) {
+          done = true;
+          break;
+        }
+        if (c == end) {
+          return false;
+        }
+        if (*c == ',') {
+          c++;
+          expectKey = !frames.back().isArray;
+          break;
+        }
+        if (*c == (frames.back().isArray ? ']' : '}')) {
+          c++;
+          if (frames.back().isArray) {
+            end_array();
+          } else {
+            end_object();
+          }
+          continue;
+        }
+        return false;
+      }
+    }
+  }
+
+  // Function to find the closing quote of an unescaped string; returns nullptr for escapes or control characters
+  static const char* scanString(const char* c, const char* end) {
+    for (c++; c != end; c++) {
+      if (*c == '"') {
+        return c;
+      }
+      if (*c == '\\' || (unsigned char)*c < 0x20) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  // Pointer of the value that starts now
+  std::string path() const {
+    if (frames.empty()) {
+      return "";
+    }
+    const Frame& frame = frames.back();
+    return frame.path + "/" + (frame.isArray ? to_string(frame.index) : frame.key);
+  }
+
+  void store(uint64_t value) {
+    if (!frames.empty() && frames.back().isArray) {
+      if (current == nullptr) {
+        current = &arrays[frames.back().path];
+      }
+      current->push_back(value);
+      frames.back().index++;
+    } else {
+      scalars[path()] = value;
+    }
+  }
+
+  // Function to step past a value that is not stored in the enclosing array
+  void next() {
+    current = nullptr;
+    if (!frames.empty() && frames.back().isArray) {
+      frames.back().index++;
+    }
+  }
+};
+
+#endif  // JSONLOADER_H
@@ -14,11 +14,14 @@
 
 
 #include "polynomial.h"
+#include "proverMetrics.h"
+#include "fidesLog.h"
 #include <iostream>
 #include <unordered_map>
 #include <random>
 // #include <openssl/evp.h>
 #include <iomanip>
+#include <sstream>
 
 
 #include <cstdint>
@@ -34,6 +37,7 @@
 uint64_t Polynomial::power(uint64_t base, uint64_t exponent, uint64_t p) {
   uint64_t result = 1;
   base = base % p;  // Handle base larger than p
+  ProverMetrics::countFieldMultiplies(2 * (64 - __builtin_clzll(exponent | 1)));
 
   while (exponent > 0) {
     // If exponent is odd, multiply the result by base
@@ -53,6 +57,7 @@ uint64_t Polynomial::power(uint64_t base, uint64_t exponent, uint64_t p) {
 uint64_t Polynomial::pExp(uint64_t a, uint64_t b, uint64_t p) {
   uint64_t result = 1;
   a = a % p;
+  ProverMetrics::countFieldMultiplies(2 * (64 - __builtin_clzll(b | 1)));
   while (b > 0) {
     if (b % 2 == 1) {  // If b is odd, multiply a with the result
       result = (result * a) % p;
@@ -65,11 +70,40 @@ uint64_t Polynomial::pExp(uint64_t a, uint64_t b, uint64_t p) {
 
 // Function to compute the p inverse using Fermat's Little Theorem
 uint64_t Polynomial::pInverse(uint64_t a, uint64_t p) {
+  ProverMetrics::countInversions(1);
   return pExp(a, p - 2, p);
 }
 
-uint64_t Polynomial::generateRandomNumber(const std::vector<uint64_t>& H, uint64_t mod) {
-    std::mt19937_64 rng(std::random_device{}());  // Use random_device to seed the generator
+// Function to invert every element of a vector in p with a single pInverse (Montgomery's trick)
+// Zero entries are left as zero, matching pInverse(0, p)
+vector<uint64_t> Polynomial::batchInverse(const vector<uint64_t>& values, uint64_t p) {
+  vector<uint64_t> result(values.size(), 0);
+  vector<uint64_t> prefix(values.size(), 1);
+  ProverMetrics::countBytesAllocated(2 * values.size() * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(3 * values.size());
+
+  // prefix[i] holds the product of all non-zero values before index i
+  uint64_t acc = 1;
+  for (size_t i = 0; i < values.size(); i++) {
+    prefix[i] = acc;
+    if (values[i] % p != 0) {
+      acc = (acc * (values[i] % p)) % p;
+    }
+  }
+
+  // Walk back from the inverse of the full product, peeling off one value at a time
+  uint64_t inv = pInverse(acc, p);
+  for (size_t i = values.size(); i-- > 0;) {
+    if (values[i] % p == 0) {
+      continue;
+    }
+    result[i] = (inv * prefix[i]) % p;
+    inv = (inv * (values[i] % p)) % p;
+  }
+  return result;
+}
+
+uint64_t Polynomial::generateRandomNumber(const std::vector<uint64_t>& H, uint64_t mod, FidesRandom::Engine& rng) {
     std::uniform_int_distribution<uint64_t> dist(0, mod - 1);
     
     uint64_t randomNumber;
@@ -80,13 +114,12 @@ uint64_t Polynomial::generateRandomNumber(const std::vector<uint64_t>& H, uint64
 }
 
 // Function to generate a random polynomial
-vector<uint64_t> Polynomial::generateRandomPolynomial(size_t numTerms, size_t maxDegree, uint64_t p) {
+vector<uint64_t> Polynomial::generateRandomPolynomial(size_t numTerms, size_t maxDegree, uint64_t p, FidesRandom::Engine& gen) {
     vector<uint64_t> polynomial(maxDegree + 1, 0); // Initialize polynomial with zeros
+    ProverMetrics::countBytesAllocated(polynomial.size() * sizeof(uint64_t));
 
     // Generate random indices for the non-zero terms
     set<size_t> indices;
-    random_device rd;
-    mt19937 gen(rd());
     uniform_int_distribution<size_t> dis(0, maxDegree);
 
     while (indices.size() < numTerms) {
@@ -106,6 +139,7 @@ vector<uint64_t> Polynomial::addPolynomials(const vector<uint64_t>& poly1, const
   // Determine the size of the result polynomial (the max size of the two input polynomials)
   size_t maxSize = max(poly1.size(), poly2.size());
   vector<uint64_t> result(maxSize, 0);
+  ProverMetrics::countBytesAllocated(3 * maxSize * sizeof(uint64_t));
 
   // Resize the smaller polynomial to match the size of the larger one
   vector<uint64_t> poly1_resized = poly1;
@@ -126,6 +160,7 @@ vector<uint64_t> Polynomial::subtractPolynomials(const vector<uint64_t>& poly1,
   // Determine the size of the result polynomial (the max size of the two input polynomials)
   size_t maxSize = max(poly1.size(), poly2.size());
   vector<uint64_t> result(maxSize, 0);
+  ProverMetrics::countBytesAllocated(3 * maxSize * sizeof(uint64_t));
 
   // Resize the smaller polynomial to match the size of the larger one
   vector<uint64_t> poly1_resized = poly1;
@@ -214,6 +249,8 @@ void NTT(vector<uint64_t>& a, bool invert, uint64_t p, uint64_t root) {
 // }
 vector<uint64_t> Polynomial::multiplyPolynomials(const vector<uint64_t>& poly1, const vector<uint64_t>& poly2, uint64_t p) {
   vector<uint64_t> result(poly1.size() + poly2.size() - 1, 0);
+  ProverMetrics::countBytesAllocated(result.size() * sizeof(uint64_t));
+  ProverMetrics::countPolynomialMultiply(poly1.size(), poly2.size());
 
   for (size_t i = 0; i < poly1.size(); i++) {
     for (size_t j = 0; j < poly2.size(); j++) {
@@ -232,6 +269,7 @@ vector<vector<uint64_t>> Polynomial::dividePolynomials(const vector<uint64_t>& d
 
   uint64_t n = remainder.size();
   uint64_t m = divisor.size();
+  ProverMetrics::countBytesAllocated(2 * n * sizeof(uint64_t));
 
   // If the divisor is larger than the dividend, the quotient is zero
   if (m > n) {
@@ -243,6 +281,8 @@ vector<vector<uint64_t>> Polynomial::dividePolynomials(const vector<uint64_t>& d
 
   // Normalize the divisor
   uint64_t inv_lead = Polynomial::pExp(divisor.back(), p - 2, p);
+  ProverMetrics::countInversions(1);
+  ProverMetrics::countFieldMultiplies(m + (n - m + 1) * (m + 1));
   vector<uint64_t> normalized_divisor(m);
   for (size_t i = 0; i < m; i++) {
     normalized_divisor[i] = (divisor[i] * inv_lead) % p;
@@ -266,9 +306,80 @@ vector<vector<uint64_t>> Polynomial::dividePolynomials(const vector<uint64_t>& d
   return result;
 }
 
+// Function to multiply a polynomial by the binomial (c0 + ck * x^k)
+vector<uint64_t> Polynomial::multiplyPolynomialByBinomial(const vector<uint64_t>& poly, uint64_t c0, uint64_t ck, uint64_t k, uint64_t p) {
+  vector<uint64_t> result(poly.size() + k, 0);
+  ProverMetrics::countBytesAllocated(result.size() * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(2 * poly.size());
+
+  for (size_t i = 0; i < poly.size(); i++) {
+    result[i] = (result[i] + poly[i] * c0) % p;
+    result[i + k] = (result[i + k] + poly[i] * ck) % p;
+  }
+  return result;
+}
+
+// Function to divide a polynomial by the binomial (x^k - c)
+// Same output layout as dividePolynomials, in O(dividend.size()) instead of O(dividend.size() * k)
+vector<vector<uint64_t>> Polynomial::dividePolynomialByBinomial(const vector<uint64_t>& dividend, uint64_t k, uint64_t c, uint64_t p) {
+  vector<uint64_t> quotient(dividend.size(), 0);
+  vector<uint64_t> remainder = dividend;
+  vector<vector<uint64_t>> result;
+  ProverMetrics::countBytesAllocated(2 * dividend.size() * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(dividend.size());
+
+  // If the divisor is larger than the dividend, the quotient is zero
+  if (k + 1 > remainder.size()) {
+    quotient.resize(1, 0);
+    result.push_back(quotient);
+    result.push_back(remainder);
+    return result;
+  }
+
+  // x^i = x^(i-k) * (x^k - c) + c * x^(i-k)
+  for (size_t i = remainder.size(); i-- > k;) {
+    quotient[i - k] = remainder[i];
+    remainder[i - k] = (remainder[i - k] + c * remainder[i]) % p;
+    remainder[i] = 0;
+  }
+
+  // Remove leading zeros from the remainder
+  while (!remainder.empty() && remainder.back() == 0) {
+    remainder.pop_back();
+  }
+
+  result.push_back(quotient);
+  result.push_back(remainder);
+  return result;
+}
+
+// Function to divide a polynomial by (x - root) using synthetic division
+vector<vector<uint64_t>> Polynomial::dividePolynomialByLinear(const vector<uint64_t>& dividend, uint64_t root, uint64_t p) {
+  vector<vector<uint64_t>> result(2);
+  if (dividend.empty()) {
+    result[0] = {0};
+    return result;
+  }
+
+  vector<uint64_t> quotient(dividend.size() - 1, 0);
+  ProverMetrics::countBytesAllocated(quotient.size() * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(quotient.size());
+  uint64_t carry = dividend.back() % p;
+  for (size_t i = dividend.size() - 1; i > 0; i--) {
+    quotient[i - 1] = carry;
+    carry = (dividend[i - 1] + carry * root) % p;
+  }
+
+  result[0] = quotient;
+  result[1] = {carry};
+  return result;
+}
+
 // Function to multiply a polynomial by a number
 vector<uint64_t> Polynomial::multiplyPolynomialByNumber(const vector<uint64_t>& H, uint64_t h, uint64_t p) {
   vector<uint64_t> result(H.size(), 0);  // Use long long to avoid overflow during multiplication
+  ProverMetrics::countBytesAllocated(result.size() * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(H.size());
 
   for (uint64_t i = 0; i < H.size(); i++) {
     result[i] = (H[i] * h) % p;
@@ -282,34 +393,40 @@ uint64_t Polynomial::subtractModP(uint64_t a, uint64_t b, uint64_t p) {
 }
 
 
+// The divided differences are updated in place, one column at a time, so only O(n) memory is needed,
+// and each column's denominators are inverted together with one batchInverse
 vector<uint64_t> Polynomial::newtonDividedDifferences(const vector<uint64_t>& x_values, const vector<uint64_t>& y_values, uint64_t p) {
     uint64_t n = x_values.size();
-    vector<vector<uint64_t>> divided_diff(n, vector<uint64_t>(n, 0));
 
-    // Fill the first column with y_values
+    // coefficients[i] starts as y_i and ends as the divided difference f[x_0, ..., x_i]
+    vector<uint64_t> coefficients(n, 0);
     for (uint64_t i = 0; i < n; i++) {
-        divided_diff[i][0] = y_values[i] % p;
+        coefficients[i] = y_values[i] % p;
     }
+    ProverMetrics::countBytesAllocated(2 * n * sizeof(uint64_t));
+    ProverMetrics::countFieldMultiplies(n * n / 2);
 
-    // Compute the divided differences
+    vector<uint64_t> denominators(n, 0);
     for (uint64_t j = 1; j < n; j++) {
-        for (uint64_t i = 0; i < n - j; i++) {
-            uint64_t numerator = (divided_diff[i + 1][j - 1] - divided_diff[i][j - 1] + p) % p;
-            uint64_t denominator = (x_values[i + j] - x_values[i] + p) % p;
-            divided_diff[i][j] = (numerator * pInverse(denominator, p)) % p;
+        for (uint64_t i = j; i < n; i++) {
+            denominators[i - j] = (x_values[i] - x_values[i - j] + p) % p;
         }
-    }
+        denominators.resize(n - j);
+        vector<uint64_t> inverses = batchInverse(denominators, p);
 
-    // Extract the coefficients for the Newton polynomial
-    vector<uint64_t> coefficients(n, 0);
-    for (uint64_t i = 0; i < n; i++) {
-        coefficients[i] = divided_diff[0][i];
+        // Walk downwards so coefficients[i - 1] still holds the previous column
+        for (uint64_t i = n - 1; i >= j; i--) {
+            uint64_t numerator = (coefficients[i] - coefficients[i - 1] + p) % p;
+            coefficients[i] = (numerator * inverses[i - j]) % p;
+        }
     }
     return coefficients;
 }
 
 vector<uint64_t> Polynomial::newtonPolynomial(const vector<uint64_t>& coefficients, const vector<uint64_t>& x_values, uint64_t p) {
     vector<uint64_t> result = {coefficients[0]}; // Start with the first term
+    ProverMetrics::countBytesAllocated(coefficients.size() * sizeof(uint64_t));
+    ProverMetrics::countFieldMultiplies(coefficients.size() * coefficients.size() / 2);
     vector<uint64_t> current_term = {1};        // Tracks the product (x - x_0)(x - x_1)...
     
     for (size_t i = 1; i < coefficients.size(); i++) {
@@ -326,7 +443,7 @@ vector<uint64_t> Polynomial::newtonPolynomial(const vector<uint64_t>& coefficien
     return result;
 }
 
-vector<uint64_t> Polynomial::setupNewtonPolynomial(const vector<uint64_t>& x_values, const vector<uint64_t>& y_values, uint64_t p, const std::string& name) {
+vector<uint64_t> Polynomial::setupNewtonPolynomial(const vector<uint64_t>& x_values, const vector<uint64_t>& y_values, uint64_t p, [[maybe_unused]] const std::string& name) {
     // Compute coefficients using divided differences
     vector<uint64_t> coefficients = newtonDividedDifferences(x_values, y_values, p);
 
@@ -334,7 +451,7 @@ vector<uint64_t> Polynomial::setupNewtonPolynomial(const vector<uint64_t>& x_val
     vector<uint64_t> polynomial = newtonPolynomial(coefficients, x_values, p);
 
     // Print and return the polynomial
-    printPolynomial(polynomial, name);
+    FIDES_LOG_DEBUG(printPolynomial(polynomial, name));
     return polynomial;
 }
 
@@ -343,6 +460,7 @@ vector<uint64_t> Polynomial::setupNewtonPolynomial(const vector<uint64_t>& x_val
 uint64_t Polynomial::evaluatePolynomial(const vector<uint64_t>& polynomial, uint64_t x, uint64_t p) {
   uint64_t result = 0;
   uint64_t power_of_x = 1; // x^0 initially
+  ProverMetrics::countFieldMultiplies(2 * polynomial.size());
 
   for (size_t i = 0; i < polynomial.size(); i++) {
     result = (result + polynomial[i] * power_of_x) % p;
@@ -372,6 +490,8 @@ vector<uint64_t> Polynomial::createLinearPolynomial(uint64_t root) {
 // Function to calculate Polynomial r(α,x) = (alpha^n - x^n) / (alpha - x)
 vector<uint64_t> Polynomial::calculatePolynomial_r_alpha_x(uint64_t alpha, uint64_t n, uint64_t p) {
   vector<uint64_t> P(n, 0);
+  ProverMetrics::countBytesAllocated(n * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(n);
 
   // Calculate each term of the polynomial P(x)
   uint64_t currentPowerOfAlpha = 1;  // alpha^0
@@ -383,8 +503,23 @@ vector<uint64_t> Polynomial::calculatePolynomial_r_alpha_x(uint64_t alpha, uint6
   return P;
 }
 
+// Function to multiply a polynomial by r(α,x) = (alpha^n - x^n) / (alpha - x) in O(n)
+// Multiplies by the binomial (alpha^n - x^n) and then divides exactly by (alpha - x) = -(x - alpha)
+vector<uint64_t> Polynomial::multiplyPolynomialBy_r_alpha_x(const vector<uint64_t>& poly, uint64_t alpha, uint64_t n, uint64_t p) {
+  vector<uint64_t> product = multiplyPolynomialByBinomial(poly, power(alpha, n, p), p - 1, n, p);
+  vector<uint64_t> quotient = dividePolynomialByLinear(product, alpha % p, p)[0];
+  for (size_t i = 0; i < quotient.size(); i++) {
+    quotient[i] = (p - quotient[i]) % p;
+  }
+  return quotient;
+}
+
 // This function calculates the value of the polynomial at a specific point 𝑘 rather than returning the coefficients.
 uint64_t Polynomial::calculatePolynomial_r_alpha_k(uint64_t alpha, uint64_t k, uint64_t n, uint64_t p) {
+  // At alpha = k the quotient is the derivative n * k^(n-1)
+  if (alpha % p == k % p) {
+    return ((n % p) * power(k, n - 1, p)) % p;
+  }
   uint64_t result = 1;
   result = subtractModP(power(alpha, n, p), power(k, n, p), p);
   uint64_t buff = subtractModP(alpha, k, p);
@@ -394,9 +529,106 @@ uint64_t Polynomial::calculatePolynomial_r_alpha_k(uint64_t alpha, uint64_t k, u
   return result;
 }
 
+// Function to calculate r(α,h) for every h in H with a single batch inversion
+// Since h^n = 1 on H, r(α,h) = (alpha^n - 1) / (alpha - h), and r(h,h) = n * h^(n-1) if alpha is in H
+vector<uint64_t> Polynomial::calculatePolynomial_r_alpha_H(uint64_t alpha, const vector<uint64_t>& H, uint64_t p) {
+  uint64_t n = H.size();
+  uint64_t numerator = subtractModP(power(alpha, n, p), 1, p);
+
+  vector<uint64_t> denominators(n, 0);
+  ProverMetrics::countBytesAllocated(n * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(n);
+  for (uint64_t i = 0; i < n; i++) {
+    denominators[i] = subtractModP(alpha % p, H[i], p);
+  }
+  vector<uint64_t> result = batchInverse(denominators, p);
+
+  for (uint64_t i = 0; i < n; i++) {
+    if (denominators[i] == 0) {
+      // h^(n-1) = h^(-1) = H[(n - i) % n]
+      result[i] = ((n % p) * H[(n - i) % n]) % p;
+    } else {
+      result[i] = (numerator * result[i]) % p;
+    }
+  }
+  return result;
+}
+
+// Function to compute the discrete Fourier transform A[j] = sum_k a[k] * w^(jk) of length n = a.size()
+// The order of H is not a power of two in general, so this is a mixed radix Cooley-Tukey over the
+// prime factors of n, falling back to a direct (zero-skipping) sum for prime lengths
+vector<uint64_t> Polynomial::dft(const vector<uint64_t>& a, uint64_t w, uint64_t p) {
+  uint64_t n = a.size();
+  if (n <= 1) {
+    return a;
+  }
+
+  // Smallest prime factor of n
+  uint64_t r = n;
+  for (uint64_t d = 2; d * d <= n; d++) {
+    if (n % d == 0) {
+      r = d;
+      break;
+    }
+  }
+
+  vector<uint64_t> wPow(n, 1);
+  ProverMetrics::countBytesAllocated(2 * n * sizeof(uint64_t));
+  ProverMetrics::countFieldMultiplies(n);
+  for (uint64_t i = 1; i < n; i++) {
+    wPow[i] = (wPow[i - 1] * w) % p;
+  }
+
+  vector<uint64_t> result(n, 0);
+  if (r == n) {
+    for (uint64_t k = 0; k < n; k++) {
+      if (a[k] == 0) continue;
+      ProverMetrics::countFieldMultiplies(n);
+      for (uint64_t j = 0; j < n; j++) {
+        result[j] = (result[j] + a[k] * wPow[(j * k) % n]) % p;
+      }
+    }
+    return result;
+  }
+
+  // Split a into r interleaved subsequences of length m, each transformed over the subgroup generated by w^r
+  uint64_t m = n / r;
+  vector<vector<uint64_t>> sub(r);
+  for (uint64_t s = 0; s < r; s++) {
+    vector<uint64_t> part(m, 0);
+    for (uint64_t t = 0; t < m; t++) {
+      part[t] = a[t * r + s];
+    }
+    sub[s] = dft(part, wPow[r], p);
+  }
+
+  ProverMetrics::countFieldMultiplies(n * r);
+  for (uint64_t j = 0; j < n; j++) {
+    uint64_t acc = 0;
+    for (uint64_t s = 0; s < r; s++) {
+      acc = (acc + wPow[(s * j) % n] * sub[s][j % m]) % p;
+    }
+    result[j] = acc;
+  }
+  return result;
+}
+
+// Function to interpolate a polynomial from its evaluations over H = {w^0, ..., w^(n-1)}
+vector<uint64_t> Polynomial::interpolateOverH(const vector<uint64_t>& evals, uint64_t w, uint64_t p) {
+  uint64_t n = evals.size();
+  vector<uint64_t> coefficients = dft(evals, pInverse(w, p), p);
+  uint64_t n_inv = pInverse(n % p, p);
+  ProverMetrics::countFieldMultiplies(n);
+  for (uint64_t i = 0; i < n; i++) {
+    coefficients[i] = (coefficients[i] * n_inv) % p;
+  }
+  return coefficients;
+}
+
 // Function to expand polynomials given the roots
 vector<uint64_t> Polynomial::expandPolynomials(const vector<uint64_t>& roots, uint64_t p) {
   vector<uint64_t> result = { 1 };  // Start with the polynomial "1"
+  ProverMetrics::countFieldMultiplies(roots.size() * roots.size() / 2);
 
   for (uint64_t root : roots) {
     // Multiply the current result polynomial by (x - root)
@@ -417,36 +649,25 @@ vector<uint64_t> Polynomial::expandPolynomials(const vector<uint64_t>& roots, ui
 
 // Function to print polynomial in serial
 void Polynomial::printPolynomial(const vector<uint64_t>& coefficients, const std::string& name) {
-  // Iterate through the coefficients and print each term of the polynomial
-  vector<int64_t> coefficientsBuf;
-  for (size_t i = 0; i < coefficients.size(); i++)
-  {
-    coefficientsBuf.push_back(coefficients[i]);
-  }
-  
-  cout << name  << " = ";
+  // Build the whole line first so polynomials printed from concurrent prover tasks do not interleave
+  ostringstream line;
+  line << name  << " = ";
   bool first = true;
-  for (int64_t i = coefficientsBuf.size() - 1; i >= 0; i--) {
-    if (coefficientsBuf[i] == 0) continue;  // Skip zero coefficients
+  for (int64_t i = coefficients.size() - 1; i >= 0; i--) {
+    if (coefficients[i] == 0) continue;  // Skip zero coefficients
 
     // Print the sign for all terms except the first
     if (!first) {
-      if (coefficientsBuf[i] > 0) {
-        cout << " + ";
-      } else {
-        cout << " - ";
-      }
+      line << " + ";
     } else {
       first = false;
     }
 
-    // Print the absolute value of the coefficient
-    cout << abs(coefficientsBuf[i]);
-
-    // Print the variable and the exponent
-    cout << "x^" << i;
+    // Print the coefficient, the variable and the exponent
+    line << coefficients[i] << "x^" << i;
   }
-  cout << endl;
+  line << "\n";
+  cout << line.str() << flush;
 }
 
 // Utility functions for trimming and removing commas
@@ -579,9 +800,11 @@ uint64_t Polynomial::e_func(uint64_t a, uint64_t b, uint64_t g, uint64_t p) {
 }
 
   // Function to calculate KZG in p
-uint64_t Polynomial::KZG_Commitment(vector<uint64_t> a, vector<uint64_t> b, uint64_t p) {
+uint64_t Polynomial::KZG_Commitment(const vector<uint64_t>& a, const vector<uint64_t>& b, uint64_t p) {
   uint64_t res = 0;
-  for (uint64_t i = 0; i < b.size(); i++) {
+  ProverMetrics::countFieldMultiplies(min(a.size(), b.size()));
+  // Quotients keep zero padding beyond the degree of ck, which contributes nothing to the commitment
+  for (uint64_t i = 0; i < b.size() && i < a.size(); i++) {
     res += (a[i] * b[i]) % p;
     res %= p;
   }
@@ -609,6 +832,51 @@ uint64_t Polynomial::hashAndExtractLower4Bytes(uint64_t inputNumber, uint64_t p)
 }
 
 
+// Function to hash a transcript of values into a challenge in p: the lower 4 bytes of the SHA-256 of their decimal
+// digits separated by commas, modulo p
+uint64_t Polynomial::hashTranscript(const vector<uint64_t>& values, uint64_t p) {
+  string transcript;
+  for (size_t i = 0; i < values.size(); i++) {
+    if (i != 0) {
+      transcript += ",";
+    }
+    transcript += to_string(values[i]);
+  }
+
+  // Compute the hash
+  string hashStr = Polynomial::SHA256(&transcript[0]);
+  string last4BytesHex = hashStr.substr(56, 8);
+
+  uint64_t result = 0;
+  std::stringstream ss;
+  ss << std::hex << last4BytesHex;
+  ss >> result;
+  return result % p;
+}
+
+
+// Function to get the weights that batch the openings of several polynomials at point. r is hashed only once the
+// evaluations are claimed, so a prover cannot move two of them so that a weighted sum it knows stays the same
+vector<uint64_t> Polynomial::openingWeights(uint64_t point, const vector<uint64_t>& commitments, const vector<uint64_t>& evaluations, uint64_t p) {
+  vector<uint64_t> transcript = { point % p };
+  for (uint64_t commitment : commitments) {
+    transcript.push_back(commitment % p);
+  }
+  for (uint64_t evaluation : evaluations) {
+    transcript.push_back(evaluation % p);
+  }
+  uint64_t r = hashTranscript(transcript, p);
+
+  vector<uint64_t> weights;
+  uint64_t weight = 1 % p;
+  for (size_t i = 0; i < evaluations.size(); i++) {
+    weights.push_back(weight);
+    weight = (weight * r) % p;
+  }
+  return weights;
+}
+
+
 
 #define uchar unsigned char
 #define uint unsigned int
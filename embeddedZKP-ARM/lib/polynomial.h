@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <algorithm>
 #include <string>
+#include "fidesRandom.h"
 
 using namespace std;
 
@@ -34,11 +35,14 @@ public:
   // Function to compute the p inverse using Fermat's Little Theorem
   static uint64_t pInverse(uint64_t a, uint64_t p);
 
+  // Function to invert every element of a vector in p with a single pInverse (Montgomery's trick)
+  static vector<uint64_t> batchInverse(const vector<uint64_t>& values, uint64_t p);
+
   // Function to generate a random number in p
-  static uint64_t generateRandomNumber(const vector<uint64_t>& H, uint64_t p);
+  static uint64_t generateRandomNumber(const vector<uint64_t>& H, uint64_t p, FidesRandom::Engine& rng = FidesRandom::threadEngine());
 
   // Function to generate a random polynomial
-  static vector<uint64_t> generateRandomPolynomial(size_t numTerms, size_t maxDegree, uint64_t p);
+  static vector<uint64_t> generateRandomPolynomial(size_t numTerms, size_t maxDegree, uint64_t p, FidesRandom::Engine& rng = FidesRandom::threadEngine());
 
   // Add two polynomials with p arithmetic
   static vector<uint64_t> addPolynomials(const vector<uint64_t>& poly1, const vector<uint64_t>& poly2, uint64_t p);
@@ -52,6 +56,15 @@ public:
   // Function to divide two polynomials
   static vector<vector<uint64_t>> dividePolynomials(const vector<uint64_t>& dividend, const vector<uint64_t>& divisor, uint64_t p);
 
+  // Function to multiply a polynomial by the binomial (c0 + ck * x^k)
+  static vector<uint64_t> multiplyPolynomialByBinomial(const vector<uint64_t>& poly, uint64_t c0, uint64_t ck, uint64_t k, uint64_t p);
+
+  // Function to divide a polynomial by the binomial (x^k - c)
+  static vector<vector<uint64_t>> dividePolynomialByBinomial(const vector<uint64_t>& dividend, uint64_t k, uint64_t c, uint64_t p);
+
+  // Function to divide a polynomial by (x - root) using synthetic division
+  static vector<vector<uint64_t>> dividePolynomialByLinear(const vector<uint64_t>& dividend, uint64_t root, uint64_t p);
+
   // Function to multiply a polynomial by a number
   static vector<uint64_t> multiplyPolynomialByNumber(const vector<uint64_t>& H, uint64_t h, uint64_t p);
 
@@ -76,9 +89,21 @@ public:
   // Function to calculate Polynomial r(α,x) = (alpha^n - x^n) / (alpha - x)
   static vector<uint64_t> calculatePolynomial_r_alpha_x(uint64_t alpha, uint64_t n, uint64_t p);
 
+  // Function to multiply a polynomial by r(α,x) = (alpha^n - x^n) / (alpha - x) in O(n)
+  static vector<uint64_t> multiplyPolynomialBy_r_alpha_x(const vector<uint64_t>& poly, uint64_t alpha, uint64_t n, uint64_t p);
+
   // Function to calculate Polynomial r(α,x) = (alpha^n - x^n) / (alpha - x)
   static uint64_t calculatePolynomial_r_alpha_k(uint64_t alpha, uint64_t k, uint64_t n, uint64_t p);
 
+  // Function to calculate r(α,h) for every h in H with a single batch inversion
+  static vector<uint64_t> calculatePolynomial_r_alpha_H(uint64_t alpha, const vector<uint64_t>& H, uint64_t p);
+
+  // Function to compute the discrete Fourier transform of a over the cyclic group generated by w
+  static vector<uint64_t> dft(const vector<uint64_t>& a, uint64_t w, uint64_t p);
+
+  // Function to interpolate a polynomial from its evaluations over H = {w^0, ..., w^(n-1)}
+  static vector<uint64_t> interpolateOverH(const vector<uint64_t>& evals, uint64_t w, uint64_t p);
+
   // Function to expand polynomials given the roots
   static vector<uint64_t> expandPolynomials(const vector<uint64_t>& roots, uint64_t p);
 
@@ -116,11 +141,18 @@ public:
   static uint64_t e_func(uint64_t a, uint64_t b, uint64_t g, uint64_t p);
 
   // Function to calculate KZG in p
-  static uint64_t KZG_Commitment(vector<uint64_t> a, vector<uint64_t> b, uint64_t p);
+  static uint64_t KZG_Commitment(const vector<uint64_t>& a, const vector<uint64_t>& b, uint64_t p);
 
   // Function to compute the SHA-256 hash of an uint64_t and return the lower 4 bytes as uint64_t, applying a modulo operation
   static uint64_t hashAndExtractLower4Bytes(uint64_t inputNumber, uint64_t p);
 
+  // Function to hash a transcript of values, their decimal digits separated by commas, into a challenge in p
+  static uint64_t hashTranscript(const vector<uint64_t>& values, uint64_t p);
+
+  // Function to get the weights that batch the openings of several polynomials at point: the powers 1, r, r^2, ...
+  // of r hashed from the point, their commitments and their claimed evaluations
+  static vector<uint64_t> openingWeights(uint64_t point, const vector<uint64_t>& commitments, const vector<uint64_t>& evaluations, uint64_t p);
+
   // Function to compute the SHA-256 hash of an uint64_t and return the lower 4 bytes as uint64_t, applying a modulo operation
   static string SHA256(char* data);
 
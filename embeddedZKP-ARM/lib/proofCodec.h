@@ -0,0 +1,434 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PROOFCODEC_H
+#define PROOFCODEC_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+#include "json.hpp"
+#include "jsonLoader.h"
+#ifdef FIDES_PROOF_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+using ordered_json = nlohmann::ordered_json;
+
+// Versioned binary encoding of the proof.
+// Layout: "FZKP", version, flags, element width, then the fields of the proof in the order of proof.json. Field
+// elements are stored little-endian in the width of the largest element, vectors and strings carry a varint length.
+// A succinct proof (FLAG_SUCCINCT, "mode": "succinct" in proof.json) carries commitments, evaluations and openings
+// in place of the polynomials; see succinctFields for its fields.
+// With FLAG_ZSTD the fields are a zstd frame preceded by their varint size; build with -DFIDES_PROOF_ZSTD -lzstd
+// to write or read such proofs. toJson and fromJson convert to and from proof.json for debugging.
+// A witness travels to a proving server the same way: "FZKW", version, element width, the commitment id and the
+// values of z_array.
+// Header only, so the prover and verifier link it without extra sources.
+class ProofCodec {
+public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t FLAG_ZSTD = 1;
+  static constexpr uint8_t FLAG_SUCCINCT = 2;
+  // Largest body a compressed proof may inflate to
+  static constexpr uint64_t MAX_INFLATED_BYTES = 1ull << 30;
+  // Points 0 .. SUCCINCT_S_POINTS - 1 at which a succinct proof opens s(x): the challenges are hashed from s(0) to
+  // s(30), and beta3 from s(31) with the commitments of g3 and h3
+  static constexpr uint64_t SUCCINCT_S_POINTS = 32;
+
+  struct Proof {
+    std::string commitmentId;
+    uint64_t Class = 0;
+    bool succinct = false;
+    // Values by their proof.json name; single field elements are stored as vectors of size 1
+    map<std::string, vector<uint64_t>> entries;
+
+    // Function to get a single field element
+    uint64_t element(const std::string& name) const {
+      const vector<uint64_t>& values = elements(name);
+      if (values.size() != 1) {
+        throw std::runtime_error("Error: Fides proof field " + name + " is not a single element");
+      }
+      return values[0];
+    }
+
+    // Function to get a vector of field elements
+    const vector<uint64_t>& elements(const std::string& name) const {
+      auto entry = entries.find(name);
+      if (entry == entries.end()) {
+        throw std::runtime_error("Error: Fides proof has no " + name + " field");
+      }
+      return entry->second;
+    }
+  };
+
+  // z_array of one execution of a committed program, as a device sends it to be proved elsewhere
+  struct Witness {
+    std::string commitmentId;
+    vector<uint64_t> values;
+  };
+
+  // Function to encode a witness
+  static vector<uint8_t> encodeWitness(const Witness& witness) {
+    uint8_t width = 1;
+    for (uint64_t value : witness.values) {
+      width = max(width, bytesFor(value));
+    }
+    vector<uint8_t> out = { 'F', 'Z', 'K', 'W', VERSION, width };
+    out.reserve(26 + witness.commitmentId.size() + witness.values.size() * width);
+    putVarint(out, witness.commitmentId.size());
+    out.insert(out.end(), witness.commitmentId.begin(), witness.commitmentId.end());
+    putVarint(out, witness.values.size());
+    for (uint64_t value : witness.values) {
+      for (uint8_t i = 0; i < width; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+      }
+    }
+    return out;
+  }
+
+  // Function to decode a witness
+  static Witness decodeWitness(const vector<uint8_t>& bytes) {
+    if (bytes.size() < 6 || bytes[0] != 'F' || bytes[1] != 'Z' || bytes[2] != 'K' || bytes[3] != 'W') {
+      throw std::runtime_error("Error: Fides message is not a witness");
+    }
+    if (bytes[4] != VERSION) {
+      throw std::runtime_error("Error: Fides witness version is not supported");
+    }
+    uint8_t width = bytes[5];
+    if (width == 0 || width > 8) {
+      throw std::runtime_error("Error: Fides witness has an invalid element width");
+    }
+    size_t pos = 6;
+    Witness witness;
+    uint64_t size = getVarint(bytes, pos);
+    need(bytes, pos, size);
+    witness.commitmentId.assign(bytes.begin() + pos, bytes.begin() + pos + size);
+    pos += size;
+    uint64_t count = getVarint(bytes, pos);
+    if (count > (bytes.size() - pos) / width) {
+      throw std::runtime_error("Error: Fides witness is truncated");
+    }
+    witness.values.resize(count);
+    for (uint64_t i = 0; i < count; i++) {
+      witness.values[i] = getElement(bytes, pos, width);
+    }
+    if (pos != bytes.size()) {
+      throw std::runtime_error("Error: Fides witness has trailing bytes");
+    }
+    return witness;
+  }
+
+  // Function to encode a proof
+  static vector<uint8_t> encode(const Proof& proof, bool compress = false) {
+    uint8_t width = 1;
+    uint64_t size = 7 + proof.commitmentId.size() + 20;
+    for (const Field& field : fields(proof.succinct)) {
+      const vector<uint64_t>& values = proof.elements(field.name);
+      if (!field.isVector && values.size() != 1) {
+        throw std::runtime_error("Error: Fides proof field " + std::string(field.name) + " is not a single element");
+      }
+      for (uint64_t value : values) {
+        width = max(width, bytesFor(value));
+      }
+      size += 10 + values.size() * sizeof(uint64_t);
+    }
+
+    vector<uint8_t> out;
+    out.reserve(size);
+    out.push_back('F');
+    out.push_back('Z');
+    out.push_back('K');
+    out.push_back('P');
+    out.push_back(VERSION);
+    out.push_back((compress ? FLAG_ZSTD : 0) | (proof.succinct ? FLAG_SUCCINCT : 0));
+    out.push_back(width);
+    if (!compress) {
+      putBody(out, proof, width);
+      return out;
+    }
+#ifdef FIDES_PROOF_ZSTD
+    vector<uint8_t> body;
+    body.reserve(size);
+    putBody(body, proof, width);
+    putVarint(out, body.size());
+    size_t header = out.size();
+    out.resize(header + ZSTD_compressBound(body.size()));
+    size_t written = ZSTD_compress(out.data() + header, out.size() - header, body.data(), body.size(), 3);
+    if (ZSTD_isError(written)) {
+      throw std::runtime_error("Error: Fides proof compression failed: " + std::string(ZSTD_getErrorName(written)));
+    }
+    out.resize(header + written);
+    return out;
+#else
+    throw std::runtime_error("Error: Fides proof compression requires a build with -DFIDES_PROOF_ZSTD -lzstd");
+#endif
+  }
+
+  // Function to decode a binary proof
+  static Proof decode(const vector<uint8_t>& bytes) {
+    if (!isBinary(bytes)) {
+      throw std::runtime_error("Error: Fides proof is not a binary proof");
+    }
+    if (bytes.size() < 7 || bytes[4] != VERSION) {
+      throw std::runtime_error("Error: Fides binary proof version is not supported");
+    }
+    uint8_t flags = bytes[5];
+    uint8_t width = bytes[6];
+    if (width == 0 || width > 8) {
+      throw std::runtime_error("Error: Fides binary proof has an invalid element width");
+    }
+    size_t pos = 7;
+
+    vector<uint8_t> inflated;
+    const vector<uint8_t>* body = &bytes;
+    if (flags & FLAG_ZSTD) {
+#ifdef FIDES_PROOF_ZSTD
+      // The sizes come from the sender, so the declared size must match the frame and stay below a bound before
+      // anything is allocated
+      uint64_t size = getVarint(bytes, pos);
+      unsigned long long frameSize = ZSTD_getFrameContentSize(bytes.data() + pos, bytes.size() - pos);
+      if (frameSize == ZSTD_CONTENTSIZE_ERROR || frameSize == ZSTD_CONTENTSIZE_UNKNOWN || frameSize != size || size > MAX_INFLATED_BYTES) {
+        throw std::runtime_error("Error: Fides binary proof has a corrupt zstd frame");
+      }
+      inflated.resize(size);
+      size_t read = ZSTD_decompress(inflated.data(), inflated.size(), bytes.data() + pos, bytes.size() - pos);
+      if (ZSTD_isError(read) || read != size) {
+        throw std::runtime_error("Error: Fides binary proof has a corrupt zstd frame");
+      }
+      body = &inflated;
+      pos = 0;
+#else
+      throw std::runtime_error("Error: Fides binary proof is compressed; rebuild with -DFIDES_PROOF_ZSTD -lzstd");
+#endif
+    }
+
+    Proof proof;
+    uint64_t size = getVarint(*body, pos);
+    need(*body, pos, size);
+    proof.commitmentId.assign(body->begin() + pos, body->begin() + pos + size);
+    pos += size;
+    proof.Class = getVarint(*body, pos);
+    proof.succinct = (flags & FLAG_SUCCINCT) != 0;
+    for (const Field& field : fields(proof.succinct)) {
+      uint64_t count = field.isVector ? getVarint(*body, pos) : 1;
+      if (count > (body->size() - pos) / width) {
+        throw std::runtime_error("Error: Fides binary proof is truncated");
+      }
+      vector<uint64_t>& values = proof.entries[field.name];
+      values.resize(count);
+      for (uint64_t i = 0; i < count; i++) {
+        values[i] = getElement(*body, pos, width);
+      }
+    }
+    if (pos != body->size()) {
+      throw std::runtime_error("Error: Fides binary proof has trailing bytes");
+    }
+    return proof;
+  }
+
+  // Function to convert a proof to the proof.json object
+  static ordered_json toJson(const Proof& proof) {
+    ordered_json json;
+    json["commitmentId"] = proof.commitmentId;
+    json["class"] = proof.Class;
+    if (proof.succinct) {
+      json["mode"] = "succinct";
+    }
+    for (const Field& field : fields(proof.succinct)) {
+      if (field.isVector) {
+        json[field.name] = proof.elements(field.name);
+      } else {
+        json[field.name] = proof.element(field.name);
+      }
+    }
+    return json;
+  }
+
+  // Function to convert a proof.json object to a proof
+  static Proof fromJson(const ordered_json& json) {
+    Proof proof;
+    proof.commitmentId = json.at("commitmentId").get<std::string>();
+    proof.Class = json.at("class").get<uint64_t>();
+    proof.succinct = json.contains("mode") && json.at("mode") == "succinct";
+    for (const Field& field : fields(proof.succinct)) {
+      if (field.isVector) {
+        proof.entries[field.name] = json.at(field.name).get<vector<uint64_t>>();
+      } else {
+        proof.entries[field.name] = { json.at(field.name).get<uint64_t>() };
+      }
+    }
+    return proof;
+  }
+
+  // Function to write an encoded proof to a file
+  static bool writeFile(const std::string& path, const vector<uint8_t>& bytes) {
+    std::ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+    file.write((const char*)bytes.data(), bytes.size());
+    return file.good();
+  }
+
+  // Function to read a proof from a binary or JSON file, whichever format it holds
+  static Proof readFile(const std::string& path) {
+    std::ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+      throw std::runtime_error("Error: Fides cannot open " + path);
+    }
+    vector<uint8_t> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    return parse(bytes, path);
+  }
+
+  // Function to decode a binary or JSON proof, whichever format bytes hold; source names it in errors
+  static Proof parse(const vector<uint8_t>& bytes, const std::string& source = "proof") {
+    if (isBinary(bytes)) {
+      return decode(bytes);
+    }
+    JsonLoader json;
+    if (!json.loadString(std::string(bytes.begin(), bytes.end()))) {
+      throw std::runtime_error("Error: Fides " + source + " is not valid JSON");
+    }
+    Proof proof;
+    proof.commitmentId = json.text("/commitmentId");
+    proof.Class = json.number("/class");
+    proof.succinct = json.has("/mode") && json.text("/mode") == "succinct";
+    for (const Field& field : fields(proof.succinct)) {
+      if (field.isVector) {
+        proof.entries[field.name] = json.take("/" + std::string(field.name));
+      } else {
+        proof.entries[field.name] = { json.number("/" + std::string(field.name)) };
+      }
+    }
+    return proof;
+  }
+
+private:
+  struct Field {
+    const char* name;
+    bool isVector;
+  };
+
+  // Function to get the fields of a full or succinct proof
+  static const vector<Field>& fields(bool succinct) {
+    return succinct ? succinctFields() : fullFields();
+  }
+
+  // Version 1 fields after commitmentId and class, in the order of proof.json
+  static const vector<Field>& fullFields() {
+    static const vector<Field> list = {
+      { "P_AHP1", false }, { "P_AHP2", true }, { "P_AHP3", true }, { "P_AHP4", true }, { "P_AHP5", true },
+      { "P_AHP6", true }, { "P_AHP7", true }, { "P_AHP8", true }, { "P_AHP9", true }, { "P_AHP10", false },
+      { "P_AHP11", true }, { "P_AHP12", true }, { "P_AHP13", false }, { "P_AHP14", true }, { "P_AHP15", true },
+      { "P_AHP16", false }, { "P_AHP17", false },
+      { "Com_AHP1_x", true }, { "Com_AHP2_x", false }, { "Com_AHP3_x", false }, { "Com_AHP4_x", false },
+      { "Com_AHP5_x", false }, { "Com_AHP6_x", false }, { "Com_AHP7_x", false }, { "Com_AHP8_x", false },
+      { "Com_AHP9_x", false }, { "Com_AHP10_x", false }, { "Com_AHP11_x", false }, { "Com_AHP12_x", false },
+      { "Com_AHP13_x", false }
+    };
+    return list;
+  }
+
+  // Fields of a succinct proof after commitmentId, class and mode: sigma1, sigma2 and sigma3 (P_AHP1, 10 and 13),
+  // s(0) .. s(31) (P_AHP18) and their opening (P_AHP19), the evaluations at beta1 of w_hat, z_hatA, z_hatB,
+  // z_hatC, h_0, s, g_1 and h_1 (P_AHP20), at beta2 of g_2 and h_2 (P_AHP21) and at beta3 of row, col and val of
+  // A, B and C, g_3 and h_3 (P_AHP22), the opening at each point (P_AHP23 to 25), and the commitments
+  static const vector<Field>& succinctFields() {
+    static const vector<Field> list = {
+      { "P_AHP1", false }, { "P_AHP10", false }, { "P_AHP13", false },
+      { "P_AHP18", true }, { "P_AHP19", false }, { "P_AHP20", true }, { "P_AHP21", true }, { "P_AHP22", true },
+      { "P_AHP23", false }, { "P_AHP24", false }, { "P_AHP25", false },
+      { "Com_AHP1_x", true }, { "Com_AHP2_x", false }, { "Com_AHP3_x", false }, { "Com_AHP4_x", false },
+      { "Com_AHP5_x", false }, { "Com_AHP6_x", false }, { "Com_AHP7_x", false }, { "Com_AHP8_x", false },
+      { "Com_AHP9_x", false }, { "Com_AHP10_x", false }, { "Com_AHP11_x", false }, { "Com_AHP12_x", false },
+      { "Com_AHP13_x", false }
+    };
+    return list;
+  }
+
+  static bool isBinary(const vector<uint8_t>& bytes) {
+    return bytes.size() >= 4 && bytes[0] == 'F' && bytes[1] == 'Z' && bytes[2] == 'K' && bytes[3] == 'P';
+  }
+
+  static void putBody(vector<uint8_t>& out, const Proof& proof, uint8_t width) {
+    putVarint(out, proof.commitmentId.size());
+    out.insert(out.end(), proof.commitmentId.begin(), proof.commitmentId.end());
+    putVarint(out, proof.Class);
+    for (const Field& field : fields(proof.succinct)) {
+      const vector<uint64_t>& values = proof.elements(field.name);
+      if (field.isVector) {
+        putVarint(out, values.size());
+      }
+      size_t pos = out.size();
+      out.resize(pos + values.size() * width);
+      for (uint64_t value : values) {
+        for (uint8_t i = 0; i < width; i++) {
+          out[pos++] = (uint8_t)(value >> (8 * i));
+        }
+      }
+    }
+  }
+
+  static uint8_t bytesFor(uint64_t value) {
+    uint8_t width = 1;
+    while (width < 8 && (value >> (8 * width)) != 0) {
+      width++;
+    }
+    return width;
+  }
+
+  static void need(const vector<uint8_t>& bytes, size_t pos, uint64_t size) {
+    if (size > bytes.size() - pos) {
+      throw std::runtime_error("Error: Fides binary proof is truncated");
+    }
+  }
+
+  static void putVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+  }
+
+  static uint64_t getVarint(const vector<uint8_t>& bytes, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      need(bytes, pos, 1);
+      uint8_t byte = bytes[pos++];
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw std::runtime_error("Error: Fides binary proof has an invalid length");
+  }
+
+  static uint64_t getElement(const vector<uint8_t>& bytes, size_t& pos, uint8_t width) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < width; i++) {
+      value |= (uint64_t)bytes[pos++] << (8 * i);
+    }
+    return value;
+  }
+};
+
+#endif  // PROOFCODEC_H
@@ -0,0 +1,1659 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "prover.h"
+#include "polynomial.h"
+#include "taskGraph.h"
+#include "proverMetrics.h"
+#include "fidesLog.h"
+#include "jsonLoader.h"
+#include "fidesSocket.h"
+#include "json.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <cstdlib>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Function to get a file name tag no other proof running at the same time uses: the process id and a per-process count
+static std::string uniqueFileTag() {
+  static atomic<uint64_t> count(0);
+  return to_string(getpid()) + "_" + to_string(count++);
+}
+
+static void releasePolynomial(vector<uint64_t>& poly) {
+  vector<uint64_t>().swap(poly);
+}
+
+// Function to move a finished proof polynomial to disk until the proof is serialized
+static void spillPolynomial(vector<uint64_t>& poly, const std::string& path) {
+  std::ofstream spillFile(path, std::ios::binary);
+  if (!spillFile.is_open()) {
+    throw std::runtime_error("Error: Fides prover cannot open " + path + " for spilling");
+  }
+  uint64_t size = poly.size();
+  spillFile.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  spillFile.write(reinterpret_cast<const char*>(poly.data()), size * sizeof(uint64_t));
+  spillFile.close();
+  releasePolynomial(poly);
+}
+
+// Function to load a polynomial written by spillPolynomial and remove its file
+static void unspillPolynomial(vector<uint64_t>& poly, const std::string& path) {
+  std::ifstream spillFile(path, std::ios::binary);
+  uint64_t size = 0;
+  if (!spillFile.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    throw std::runtime_error("Error: Fides prover cannot read " + path);
+  }
+  poly.resize(size);
+  spillFile.read(reinterpret_cast<char*>(poly.data()), size * sizeof(uint64_t));
+  spillFile.close();
+  std::remove(path.c_str());
+}
+
+// Function to load directory/path, or to read it from stdin if it cannot be opened and promptIfMissing is set
+static void loadJsonFile(JsonLoader& json, const std::string& directory, const std::string& path, bool promptIfMissing) {
+  if (json.loadFile(directory + "/" + path)) {
+    return;
+  }
+  if (!promptIfMissing) {
+    throw std::runtime_error("Error: Fides cannot load " + directory + "/" + path);
+  }
+  cout << "Enter the content of " << path << " file! (end with a blank line):" << endl;
+  string jsonInput;
+  string jsonLines;
+  while (getline(cin, jsonLines)) {
+    if (jsonLines.empty()) break;
+    jsonInput += jsonLines + "\n";
+  }
+  if (!json.loadString(jsonInput)) {
+    throw std::runtime_error("Error: Fides " + path + " is not valid JSON");
+  }
+}
+
+ProverKeys Prover::loadKeys(const std::string& directory, bool promptIfMissing) {
+  ProverKeys keys;
+  keys.directory = directory;
+  ProverMetrics::Scope loadingScope("loading");
+
+  JsonLoader commitmentJsonData;
+  loadJsonFile(commitmentJsonData, directory, "program_commitment.json", promptIfMissing);
+
+  // Extract data from the parsed JSON
+  keys.Class = commitmentJsonData.number("/class");
+  keys.commitmentID = commitmentJsonData.text("/commitmentId");
+  keys.rowA_x = commitmentJsonData.take("/row_AHP_A");
+  keys.colA_x = commitmentJsonData.take("/col_AHP_A");
+  keys.valA_x = commitmentJsonData.take("/val_AHP_A");
+  keys.rowB_x = commitmentJsonData.take("/row_AHP_B");
+  keys.colB_x = commitmentJsonData.take("/col_AHP_B");
+  keys.valB_x = commitmentJsonData.take("/val_AHP_B");
+  keys.rowC_x = commitmentJsonData.take("/row_AHP_C");
+  keys.colC_x = commitmentJsonData.take("/col_AHP_C");
+  keys.valC_x = commitmentJsonData.take("/val_AHP_C");
+  for (int i = 0; i < 9; i++) {
+    keys.Com_AHP.push_back(commitmentJsonData.number("/Com_AHP" + to_string(i)));
+  }
+
+
+  JsonLoader paramJsonData;
+  loadJsonFile(paramJsonData, directory, "program_param.json", promptIfMissing);
+  keys.nonZeroA = paramJsonData.take("/A");
+  keys.nonZeroB = paramJsonData.takeRows("/B");
+  keys.nonZeroC = paramJsonData.take("/C");
+  keys.rowA = paramJsonData.take("/rA");
+  keys.colA = paramJsonData.take("/cA");
+  keys.valA = paramJsonData.take("/vA");
+  keys.rowB = paramJsonData.take("/rB");
+  keys.colB = paramJsonData.take("/cB");
+  keys.valB = paramJsonData.take("/vB");
+  keys.rowC = paramJsonData.take("/rC");
+  keys.colC = paramJsonData.take("/cC");
+  keys.valC = paramJsonData.take("/vC");
+  if (paramJsonData.has("/line")) {
+    keys.line = paramJsonData.number("/line");
+  }
+
+
+
+  JsonLoader classJsonData;
+  loadJsonFile(classJsonData, directory, "class.json", promptIfMissing);
+  string class_value = to_string(keys.Class); // Convert integer to string class
+  keys.n_g = classJsonData.number("/" + class_value + "/n_g");
+  keys.n_i = classJsonData.number("/" + class_value + "/n_i");
+  keys.n   = classJsonData.number("/" + class_value + "/n");
+  keys.m   = classJsonData.number("/" + class_value + "/m");
+  keys.p   = classJsonData.number("/" + class_value + "/p");
+  keys.g   = classJsonData.number("/" + class_value + "/g");
+
+
+  JsonLoader setupJsonData;
+  loadJsonFile(setupJsonData, directory, "data/setup" + class_value + ".json", promptIfMissing);
+  keys.ck = setupJsonData.take("/ck");
+  keys.vk = setupJsonData.number("/vk");
+  keys.commitment = CommitmentBackend::createForProofs(CommitmentBackend::nameFromEnv(), keys.ck, keys.vk, keys.g, keys.p);
+  loadingScope.stop();
+
+  ProverMetrics::Scope setupScope("setup");
+  const uint64_t n = keys.n, m = keys.m, p = keys.p, g = keys.g;
+  vector<uint64_t>& H = keys.H;
+  vector<uint64_t>& K = keys.K;
+  uint64_t g_n;
+
+  H.push_back(1);
+  g_n = ((p - 1) / n) % p;
+  keys.w = Polynomial::power(g, g_n, p);
+  for (uint64_t i = 1; i < n; i++) {
+    H.push_back(Polynomial::power(keys.w, i, p));
+  }
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
+  cout << "H[n]: ";
+  for (uint64_t i = 0; i < n; i++) {
+    cout << H[i] << " ";
+  }
+  cout << endl;
+#endif
+
+  uint64_t y, g_m;
+
+  K.push_back(1);
+  g_m = ((p - 1) * Polynomial::pInverse(m, p)) % p;
+  y = Polynomial::power(g, g_m, p);
+  for (uint64_t i = 1; i < m; i++) {
+    K.push_back(Polynomial::power(y, i, p));
+  }
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
+  cout << "K[m]: ";
+  for (uint64_t i = 0; i < m; i++) {
+    cout << K[i] << " ";
+  }
+  cout << endl;
+#endif
+
+  keys.vH_x.assign(n + 1, 0);
+  keys.vH_x[0] = p - 1;
+  keys.vH_x[n] = 1;
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(keys.vH_x, "vH(x)"));
+
+  // K is the multiplicative subgroup of order m, so the product of (x - K[i]) is x^m - 1
+  keys.vK_x.assign(m + 1, 0);
+  keys.vK_x[0] = p - 1;
+  keys.vK_x[m] = 1;
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(keys.vK_x, "vK(x)"));
+
+  // Every r(col, x) vanishes on H except at col, where r(col, col) = n * col^(n-1), so M_hat(x) is built in
+  // evaluation form by scattering r(alpha, row) * r(row, row) * val into an n-vector and interpolating once over H
+  keys.r_h_h.assign(n, 0);
+  for (uint64_t i = 0; i < n; i++) {
+    keys.H_index[H[i]] = i;
+    keys.r_h_h[i] = ((n % p) * H[(n - i) % n]) % p;
+  }
+
+  // x_hat(x) interpolates the public part of z over the first t points of H; v_H and vH / v_H, which vanishes
+  // on the remaining points, only depend on the domain, so every proof shares them
+  uint64_t t = keys.n_i + 1;
+  vector<uint64_t> zero_to_t_for_H(H.begin(), H.begin() + t);
+  keys.v_H = Polynomial::expandPolynomials(zero_to_t_for_H, p);
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(keys.v_H, "v_H"));
+  keys.vH_div_v_H = Polynomial::dividePolynomials(keys.vH_x, keys.v_H, p)[0];
+  keys.vH_div_v_H.resize(n - t + 1);
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(keys.vH_div_v_H, "vH(x) / v_H(x)"));
+  setupScope.stop();
+
+  return keys;
+}
+
+// Offline sets are stored like spilled polynomials, as native uint64_t values: a magic, the commitment id and every
+// field of ProverOffline in declaration order, vectors and the id preceded by their size
+static const uint64_t OFFLINE_MAGIC = 0x324c46464f534446;  // "FDSOFFL2"
+static const uint64_t SUMCHECK1_CHECKPOINT_MAGIC = 0x31534b4843534446;  // "FDSCHKS1"
+
+struct OfflineWriter {
+  std::ofstream& file;
+  void value(uint64_t& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void values(vector<uint64_t>& values) {
+    uint64_t size = values.size();
+    value(size);
+    file.write(reinterpret_cast<const char*>(values.data()), size * sizeof(uint64_t));
+  }
+};
+
+struct OfflineReader {
+  std::ifstream& file;
+  void value(uint64_t& value) {
+    if (!file.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+      throw std::runtime_error("Error: Fides offline set is truncated");
+    }
+  }
+  void values(vector<uint64_t>& values) {
+    uint64_t size = 0;
+    value(size);
+    if (size > (1ull << 32)) {
+      throw std::runtime_error("Error: Fides offline set is corrupt");
+    }
+    values.resize(size);
+    if (!file.read(reinterpret_cast<char*>(values.data()), size * sizeof(uint64_t))) {
+      throw std::runtime_error("Error: Fides offline set is truncated");
+    }
+  }
+};
+
+// Function to pass every field of an offline set after the commitment id to io, in the order of the file
+template <typename Io>
+static void offlineFields(ProverOffline& offline, Io& io) {
+  io.value(offline.b);
+  io.values(offline.maskA);
+  io.values(offline.maskB);
+  io.values(offline.maskC);
+  io.values(offline.mask_w);
+  io.values(offline.s_x);
+  io.value(offline.sigma1);
+  io.value(offline.alpha);
+  io.value(offline.etaA);
+  io.value(offline.etaB);
+  io.value(offline.etaC);
+  io.value(offline.beta1);
+  io.value(offline.beta2);
+  io.value(offline.x_prime);
+  io.values(offline.eta_p);
+  io.values(offline.Sum_M_eta_M_r_M_alpha_x);
+  io.value(offline.sigma2);
+  io.value(offline.sigma3);
+  io.values(offline.g_2_x);
+  io.values(offline.h_2_x);
+  io.values(offline.g_3_x);
+  io.values(offline.h_3_x);
+  io.values(offline.p_x_offline);
+  io.values(offline.Com_AHP_x);
+}
+
+// Function to write a file of native uint64_t values under a name readers ignore and rename it to directory/name
+// when complete, so a reader never sees half a file
+static void writeValuesFile(const std::string& directory, const std::string& name, const function<void(OfflineWriter&)>& write) {
+  std::string partial = directory + "/." + name;
+  std::ofstream file(partial, ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Error: Fides prover cannot open " + partial);
+  }
+  OfflineWriter writer{ file };
+  write(writer);
+  file.close();
+  if (!file.good() || rename(partial.c_str(), (directory + "/" + name).c_str()) != 0) {
+    std::remove(partial.c_str());
+    throw std::runtime_error("Error: Fides prover cannot write " + directory + "/" + name);
+  }
+}
+
+// Function to write an offline set to directory/name
+static void writeOfflineFile(const std::string& directory, const std::string& name, const ProverOffline& offline) {
+  ProverOffline fields = offline;
+  writeValuesFile(directory, name, [&](OfflineWriter& writer) {
+    uint64_t magic = OFFLINE_MAGIC;
+    vector<uint64_t> id(fields.commitmentID.begin(), fields.commitmentID.end());
+    writer.value(magic);
+    writer.values(id);
+    offlineFields(fields, writer);
+  });
+}
+
+// Function to read an offline set of the commitment of keys from path
+static ProverOffline readOfflineFile(const ProverKeys& keys, const std::string& path) {
+  std::ifstream file(path, ios::binary);
+  OfflineReader reader{ file };
+  ProverOffline offline;
+  uint64_t magic = 0;
+  vector<uint64_t> id;
+  reader.value(magic);
+  if (magic != OFFLINE_MAGIC) {
+    throw std::runtime_error("Error: Fides " + path + " is not an offline set");
+  }
+  reader.values(id);
+  offline.commitmentID.assign(id.begin(), id.end());
+  offlineFields(offline, reader);
+  if (offline.commitmentID != keys.commitmentID || offline.eta_p.size() != 21 || offline.Com_AHP_x.size() != 14) {
+    throw std::runtime_error("Error: Fides " + path + " does not belong to commitment " + keys.commitmentID);
+  }
+  offline.ready = true;
+  return offline;
+}
+
+// Function to get the file name prefix of the stored offline sets of the commitment of keys
+static std::string offlinePrefix(const ProverKeys& keys) {
+  return "offline_" + keys.commitmentID.substr(0, 16) + "_";
+}
+
+// Function to list the stored offline sets of the commitment of keys
+static vector<std::string> offlineFiles(const ProverKeys& keys) {
+  vector<std::string> files;
+  std::string prefix = offlinePrefix(keys);
+  DIR* directory = opendir((keys.directory + "/data").c_str());
+  if (directory == nullptr) {
+    return files;
+  }
+  while (dirent* entry = readdir(directory)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0) {
+      files.push_back(name);
+    }
+  }
+  closedir(directory);
+  return files;
+}
+
+// One proof of a task graph: its witness, or nullptr to only compute offline material, and the offline material
+// to use up (ready) or to fill in (not ready), or nullptr to compute every phase
+struct ProofJob {
+  const uint64_t* witness;
+  size_t count;
+  ProverOffline* offline;
+  bool checkpoint;
+  bool succinct;
+};
+
+// Function to add the tasks of proof index to graph, recurse for the next proof of the batch and run the graph
+// after the last one. Every level keeps the state of its proof on its own stack frame until the shared graph has
+// run, then assembles proofs[index]
+static void proveFrom(TaskGraph& graph, const ProverKeys& keys, const vector<ProofJob>& jobs, size_t index, size_t end, uint64_t memoryBudget, vector<ProofCodec::Proof>& proofs) {
+  const ProofJob& job = jobs[index];
+  const uint64_t* witness = job.witness;
+  bool online = witness != nullptr;
+
+  // A checkpointed proof resumes from what an interrupted attempt left in data/: the offline checkpoint stands in
+  // for the offline material, and the sumcheck 1 checkpoint, if taken for the same witness, for the witness phases
+  bool checkpoint = job.checkpoint && online;
+  bool succinct = job.succinct && online;
+  std::string checkpointDirectory = keys.directory + "/data";
+  std::string offlineCheckpoint = "checkpoint_" + keys.commitmentID.substr(0, 16) + "_offline.bin";
+  std::string sumcheck1Checkpoint = "checkpoint_" + keys.commitmentID.substr(0, 16) + "_sumcheck1.bin";
+  ProverOffline resumed;
+  ProverOffline* material = job.offline;
+  if (checkpoint && access((checkpointDirectory + "/" + offlineCheckpoint).c_str(), F_OK) == 0) {
+    try {
+      resumed = readOfflineFile(keys, checkpointDirectory + "/" + offlineCheckpoint);
+      material = &resumed;
+      FIDES_LOG_INFO(cout << "Resuming the proof from " << checkpointDirectory << "/" << offlineCheckpoint << endl);
+    } catch (const std::exception& error) {
+      FIDES_LOG_ERROR(cerr << error.what() << "; starting over" << endl);
+    }
+  }
+  bool resumedOffline = material == &resumed;
+  // The stored set the caller took for this proof is unused and was never revealed, so it goes back to the
+  // store for a later proof instead of being lost
+  if (resumedOffline && job.offline != nullptr && job.offline->ready) {
+    try {
+      Prover::storeOffline(keys, *job.offline);
+    } catch (const std::exception& error) {
+      FIDES_LOG_ERROR(cerr << error.what() << "; unused offline set discarded" << endl);
+    }
+  }
+  bool witnessDone = false;
+
+  // The witness-dependent (online) tasks are skipped when only precomputing, and the witness-independent
+  // (offline) tasks are skipped when their results come from a ready ProverOffline
+  bool offline = material == nullptr || !material->ready;
+  if (!offline && material->commitmentID != keys.commitmentID) {
+    throw std::runtime_error("Error: Fides offline material was computed for commitment " + material->commitmentID);
+  }
+
+  // The keys are only read below; the aliases keep the names of the protocol description
+  const uint64_t n_i = keys.n_i, n_g = keys.n_g, n = keys.n, m = keys.m, p = keys.p, w = keys.w;
+  const vector<uint64_t>& rowA_x = keys.rowA_x;
+  const vector<uint64_t>& colA_x = keys.colA_x;
+  const vector<uint64_t>& valA_x = keys.valA_x;
+  const vector<uint64_t>& rowB_x = keys.rowB_x;
+  const vector<uint64_t>& colB_x = keys.colB_x;
+  const vector<uint64_t>& valB_x = keys.valB_x;
+  const vector<uint64_t>& rowC_x = keys.rowC_x;
+  const vector<uint64_t>& colC_x = keys.colC_x;
+  const vector<uint64_t>& valC_x = keys.valC_x;
+  const vector<uint64_t>& nonZeroA = keys.nonZeroA;
+  const vector<vector<uint64_t>>& nonZeroB = keys.nonZeroB;
+  const vector<uint64_t>& nonZeroC = keys.nonZeroC;
+  const vector<uint64_t>& rowA = keys.rowA;
+  const vector<uint64_t>& colA = keys.colA;
+  const vector<uint64_t>& valA = keys.valA;
+  const vector<uint64_t>& rowB = keys.rowB;
+  const vector<uint64_t>& colB = keys.colB;
+  const vector<uint64_t>& valB = keys.valB;
+  const vector<uint64_t>& rowC = keys.rowC;
+  const vector<uint64_t>& colC = keys.colC;
+  const vector<uint64_t>& valC = keys.valC;
+  const CommitmentBackend& backend = *keys.commitment;
+  const vector<uint64_t>& H = keys.H;
+  const vector<uint64_t>& K = keys.K;
+  const vector<uint64_t>& vH_x = keys.vH_x;
+  const vector<uint64_t>& r_h_h = keys.r_h_h;
+  const unordered_map<uint64_t, uint64_t>& H_index = keys.H_index;
+  const vector<uint64_t>& v_H = keys.v_H;
+  const vector<uint64_t>& vH_div_v_H = keys.vH_div_v_H;
+
+  if (online && job.count < 1 + n_i + n_g) {
+    throw std::runtime_error("Error: Fides prover needs " + to_string(1 + n_i + n_g) + " witness values, got " + to_string(job.count));
+  }
+
+  ProverMetrics::Scope setupScope("setup");
+
+  uint64_t upper_limit = (n_g < 10) ? n_g - 1 : 9;
+  // One engine per proof, created in the order the proofs are added, so with FIDESINNOVA_SEED a batch draws the
+  // same values whichever worker runs which task
+  FidesRandom::Engine gen = FidesRandom::engine();
+  std::uniform_int_distribution<uint64_t> dis(0, upper_limit);
+  int64_t b = offline ? dis(gen) : material->b;
+
+  vector<uint64_t> z;
+  for(uint64_t i = 0; online && i < (1 + n_i + n_g); i++) {
+    FIDES_LOG_DEBUG(cout << "z_array" << "[" << i << "] = " << witness[i] % p << endl);
+    z.push_back(witness[i] % p);
+  }
+
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
+  cout << "\n\n" << endl;
+  cout << "z" << "[";
+  for(uint64_t i = 0; i < z.size(); i++) {
+    cout << z[i] << ", ";
+  }
+  cout << "]" << endl;
+#endif
+
+  uint64_t t = n_i + 1;
+
+  // z_hatA/B/C and w_hat are masked for zero knowledge by adding r(x) times a polynomial that vanishes where they
+  // are fixed, with b random coefficients in r(x). The masks are drawn up front, so the interpolation tasks below
+  // only read shared state, and the interpolations themselves run over H
+  std::uniform_int_distribution<uint64_t> coefficient(0, p - 1);
+  vector<uint64_t> maskA, maskB, maskC, mask_w;
+  for (int64_t i = 0; offline && i < b; i++) {
+    maskA.push_back(coefficient(gen));
+    maskB.push_back(coefficient(gen));
+    maskC.push_back(coefficient(gen));
+    mask_w.push_back(coefficient(gen));
+  }
+
+  setupScope.stop();
+
+  // The prover is a dependency graph of tasks; independent phases run concurrently on a work-stealing pool.
+  // Every value written by a task is declared here and only read by tasks that list the writer as a dependency.
+  typedef TaskGraph::TaskId TaskId;
+
+  // Tasks are added through addTask, which times and counts each one under the current value of phase in the
+  // metrics registry of the calling thread, whichever worker runs it
+  std::string phase;
+  ProverMetrics::Registry& metrics = ProverMetrics::registry();
+  auto addTask = [&](const std::string& name, function<void()> fn, const vector<TaskId>& deps = {}, uint64_t bytes = 0) {
+    std::string taskPhase = phase;
+    return graph.addTask(name, [&metrics, taskPhase, fn] {
+      ProverMetrics::Scope scope(metrics, taskPhase);
+      fn();
+    }, deps, bytes);
+  };
+
+  // Tasks of a skipped kind are not added; the empty task stands in for them in the dependency lists
+  TaskId tSkipped = graph.addTask("skipped", [] {});
+  auto addOnlineTask = [&](const std::string& name, function<void()> fn, const vector<TaskId>& deps = {}, uint64_t bytes = 0) {
+    return online && !witnessDone ? addTask(name, fn, deps, bytes) : tSkipped;
+  };
+  // A full proof opens p(x) at x_prime and a succinct one every polynomial at its challenge point
+  auto addOpeningTask = [&](const std::string& name, function<void()> fn, const vector<TaskId>& deps = {}, uint64_t bytes = 0, bool succinctOpening = false) {
+    return online && succinctOpening == succinct ? addTask(name, fn, deps, bytes) : tSkipped;
+  };
+  auto addOfflineTask = [&](const std::string& name, function<void()> fn, const vector<TaskId>& deps = {}, uint64_t bytes = 0) {
+    return offline ? addTask(name, fn, deps, bytes) : tSkipped;
+  };
+
+  // A memory budget bounds the estimated memory of concurrently running tasks and spills finished proof
+  // polynomials to disk until the proof is assembled. Intermediates are released after their last consumer
+  // in every mode. Estimates are in units of one polynomial over H (degree 2n + b) or over K (degree m).
+  uint64_t polyBytesH = (2 * n + b + 1) * sizeof(uint64_t);
+  uint64_t polyBytesK = (2 * m + 1) * sizeof(uint64_t);
+
+  vector<uint64_t> Az(n, 0), Bz(n, 0), Cz(n, 0);
+  vector<uint64_t> z_hatA, z_hatB, z_hatC;
+  vector<uint64_t> polyX_HAT_H, w_hat_x, z_hat_x, h_0_x;
+  vector<uint64_t> s_x;
+  uint64_t sigma1 = 0;
+  uint64_t alpha = 0, etaA = 0, etaB = 0, etaC = 0, beta1 = 0, beta2 = 0;
+  vector<uint64_t> r_Sum_x, r_alpha_H, A_hat, B_hat, C_hat, Sum_M_eta_M_r_M_alpha_x;
+  vector<uint64_t> g_1_x, h_1_x;
+  uint64_t sigma2 = 0;
+  vector<uint64_t> r_beta1_H, A_hat_M_hat, B_hat_M_hat, C_hat_M_hat;
+  vector<uint64_t> g_2_x, h_2_x;
+  vector<uint64_t> points_f_3(K.size(), 0);
+  uint64_t sigma3 = 0, vH_beta1 = 0, vH_beta2 = 0;
+  vector<uint64_t> poly_pi_a, poly_pi_b, poly_pi_c;
+  vector<uint64_t> poly_pi_bc, poly_pi_ac, poly_pi_ab;
+  vector<uint64_t> a_x, b_x;
+  vector<uint64_t> g_3_x, poly_f_3x_new, sigma_3_set_k;
+  vector<uint64_t> h_3_x;
+  vector<uint64_t> eta_p(21, 0);
+  uint64_t x_prime = 0, y_prime = 0, p_17_AHP = 0;
+  vector<uint64_t> p_x_offline;
+  vector<uint64_t> Com_AHP_x(14, 0);
+
+  if (!offline) {
+    maskA = std::move(material->maskA);
+    maskB = std::move(material->maskB);
+    maskC = std::move(material->maskC);
+    mask_w = std::move(material->mask_w);
+    s_x = std::move(material->s_x);
+    sigma1 = material->sigma1;
+    alpha = material->alpha;
+    etaA = material->etaA;
+    etaB = material->etaB;
+    etaC = material->etaC;
+    beta1 = material->beta1;
+    beta2 = material->beta2;
+    x_prime = material->x_prime;
+    eta_p = std::move(material->eta_p);
+    Sum_M_eta_M_r_M_alpha_x = std::move(material->Sum_M_eta_M_r_M_alpha_x);
+    sigma2 = material->sigma2;
+    sigma3 = material->sigma3;
+    g_2_x = std::move(material->g_2_x);
+    h_2_x = std::move(material->h_2_x);
+    g_3_x = std::move(material->g_3_x);
+    h_3_x = std::move(material->h_3_x);
+    p_x_offline = std::move(material->p_x_offline);
+    Com_AHP_x = std::move(material->Com_AHP_x);
+    // The masks of a proof must never be reused, so the material is used up here whatever happens next
+    *material = ProverOffline();
+  }
+
+  // The witness phases are skipped as well when the sumcheck 1 checkpoint of the same witness is resumed
+  std::string sumcheck1Path = checkpointDirectory + "/" + sumcheck1Checkpoint;
+  if (resumedOffline && access(sumcheck1Path.c_str(), F_OK) == 0) {
+    try {
+      std::ifstream file(sumcheck1Path, ios::binary);
+      OfflineReader reader{ file };
+      uint64_t magic = 0;
+      vector<uint64_t> id, checkpointZ, checkpointCom;
+      reader.value(magic);
+      reader.values(id);
+      reader.values(checkpointZ);
+      if (magic == SUMCHECK1_CHECKPOINT_MAGIC && std::string(id.begin(), id.end()) == keys.commitmentID && checkpointZ == z) {
+        reader.values(w_hat_x);
+        reader.values(z_hatA);
+        reader.values(z_hatB);
+        reader.values(z_hatC);
+        reader.values(h_0_x);
+        reader.values(g_1_x);
+        reader.values(h_1_x);
+        reader.values(checkpointCom);
+        for (uint64_t i : { 2, 3, 4, 5, 6, 8, 9 }) {
+          Com_AHP_x[i] = checkpointCom.at(i);
+        }
+        witnessDone = true;
+      }
+    } catch (const std::exception& error) {
+      FIDES_LOG_ERROR(cerr << error.what() << "; proving sumcheck 1 again" << endl);
+    }
+  }
+
+  phase = "witness products";
+  // Az, Bz and Cz are computed from the nonzero entries directly; the dense n x n matrices are never built.
+  // Row i + n_i + 1 of A and C holds a single 1 at column nonZeroA[i] and nonZeroC[i]
+  TaskId tMatVec = addOnlineTask("Az, Bz, Cz", [&] {
+    for (uint64_t i = 0; i < nonZeroA.size(); i++) {
+      Az[i + n_i + 1] = (Az[i + n_i + 1] + z[nonZeroA[i]]) % p;
+    }
+    for (const auto& entry : nonZeroB) {
+      uint64_t row = entry[0];
+      uint64_t col = entry[1];
+      uint64_t val = entry[2] % p;
+      Bz[row] = (Bz[row] + (val * z[col]) % p) % p;
+    }
+    for (uint64_t i = 0; i < nonZeroC.size(); i++) {
+      Cz[i + n_i + 1] = (Cz[i + n_i + 1] + z[nonZeroC[i]]) % p;
+    }
+  });
+
+  phase = "interpolations";
+  // z_hatM(x) interpolates Mz over H and adds r_M(x)vH(x), which vanishes on H; vH(x) = x^n - 1, so the mask
+  // is added as r_M shifted by n minus r_M
+  auto interpolate_z_hat = [&](const vector<uint64_t>& Mz, const vector<uint64_t>& mask, [[maybe_unused]] const std::string& name) {
+    vector<uint64_t> z_hatM = Polynomial::interpolateOverH(Mz, w, p);
+    z_hatM.resize(n + mask.size(), 0);
+    for (uint64_t i = 0; i < mask.size(); i++) {
+      z_hatM[i] = Polynomial::subtractModP(z_hatM[i], mask[i], p);
+      z_hatM[n + i] = (z_hatM[n + i] + mask[i]) % p;
+    }
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(z_hatM, name));
+    return z_hatM;
+  };
+  TaskId tZA = addOnlineTask("z_hatA", [&] { z_hatA = interpolate_z_hat(Az, maskA, "z_hatA(x)"); }, { tMatVec }, 2 * polyBytesH);
+  TaskId tZB = addOnlineTask("z_hatB", [&] { z_hatB = interpolate_z_hat(Bz, maskB, "z_hatB(x)"); }, { tMatVec }, 2 * polyBytesH);
+  TaskId tZC = addOnlineTask("z_hatC", [&] { z_hatC = interpolate_z_hat(Cz, maskC, "z_hatC(x)"); }, { tMatVec }, 2 * polyBytesH);
+
+  vector<uint64_t> zero_to_t_for_H(H.begin(), H.begin() + t);
+  TaskId tXHat = addOnlineTask("x_hat", [&] {
+    vector<uint64_t> zero_to_t_for_z(z.begin(), z.begin() + t);
+    polyX_HAT_H = Polynomial::setupNewtonPolynomial(zero_to_t_for_H, zero_to_t_for_z, p, "x_hat(h)");
+  });
+
+  // w_hat(x) takes (z(h) - x_hat(h)) / v_H(h) on the other points of H. z interpolated over all of H minus x_hat
+  // vanishes on the first t points, so w_hat is that difference divided by v_H, plus the mask r_w(x)vH(x)/v_H(x)
+  TaskId tWHat = addOnlineTask("w_hat", [&] {
+    vector<uint64_t> z_over_H = Polynomial::interpolateOverH(vector<uint64_t>(z.begin(), z.begin() + n), w, p);
+    w_hat_x = Polynomial::dividePolynomials(Polynomial::subtractPolynomials(z_over_H, polyX_HAT_H, p), v_H, p)[0];
+    w_hat_x.resize(n - t, 0);
+    if (!mask_w.empty()) {
+      w_hat_x = Polynomial::addPolynomials(w_hat_x, Polynomial::multiplyPolynomials(mask_w, vH_div_v_H, p), p);
+    }
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(w_hat_x, "w_hat(x)"));
+  }, { tXHat }, 3 * polyBytesH);
+
+  TaskId tZHat = addOnlineTask("z_hat", [&] {
+    z_hat_x = Polynomial::addPolynomials(Polynomial::multiplyPolynomials(w_hat_x, v_H, p), polyX_HAT_H, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(z_hat_x, "z_hat(x)"));
+  }, { tWHat }, 3 * polyBytesH);
+
+  phase = "witness products";
+  TaskId tH0 = addOnlineTask("h_0", [&] {
+    vector<uint64_t> productAB = Polynomial::multiplyPolynomials(z_hatA, z_hatB, p);
+    vector<uint64_t> zAzB_zC = Polynomial::subtractPolynomials(productAB, z_hatC, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(zAzB_zC, "zA(x)zB(x)-zC(x)"));
+
+    // Dividing the product of zAzB_zC by vH_x
+    h_0_x = Polynomial::dividePolynomialByBinomial(zAzB_zC, n, 1, p)[0];
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(h_0_x, "h0(x)"));
+  }, { tZA, tZB, tZC }, 4 * polyBytesH);
+
+  phase = "challenges";
+  TaskId tS = addOfflineTask("s", [&] {
+    s_x = Polynomial::generateRandomPolynomial(n, (2*n)+b-1, p, gen);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(s_x, "s(x)"));
+
+    sigma1 = Polynomial::sumOfEvaluations(s_x, H, p);
+    FIDES_LOG_DEBUG(cout << "sigma1 = " << sigma1 << endl);
+  }, {}, polyBytesH);
+
+  // Fiat-Shamir barriers: every verifier challenge is derived by hashing the transcript, so each round's
+  // challenges are a task of their own that depends on the transcript it hashes. Only s(x) is hashed today;
+  // binding more of the transcript means adding the producing tasks to these dependency lists.
+  TaskId tRound1 = addOfflineTask("challenges alpha, etaA, etaB, etaC", [&] {
+    alpha = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 0, p), p);
+    etaA = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 1, p), p);
+    etaB = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 2, p), p);
+    etaC = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 3, p), p);
+    FIDES_LOG_DEBUG(cout << "alpha = " << alpha << endl);
+    FIDES_LOG_DEBUG(cout << "etaA = " << etaA << endl);
+    FIDES_LOG_DEBUG(cout << "etaB = " << etaB << endl);
+    FIDES_LOG_DEBUG(cout << "etaC = " << etaC << endl);
+  }, { tS });
+
+  TaskId tRound2 = addOfflineTask("challenge beta1", [&] {
+    beta1 = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 8, p), p);
+    FIDES_LOG_DEBUG(cout << "beta1 = " << beta1 << endl);
+  }, { tS });
+
+  TaskId tRound3 = addOfflineTask("challenge beta2", [&] {
+    beta2 = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 9, p), p);
+    FIDES_LOG_DEBUG(cout << "beta2 = " << beta2 << endl);
+  }, { tS });
+
+  TaskId tRound4 = addOfflineTask("challenges eta_*, x_prime", [&] {
+    // eta_p[k - 10] is the challenge derived from s(10) .. s(30) that weights each polynomial in p(x)
+    for (uint64_t k = 10; k <= 30; k++) {
+      eta_p[k - 10] = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, k, p), p);
+    }
+    x_prime = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 22, p), p);
+  }, { tS });
+
+  // First sumcheck
+  phase = "sumcheck 1";
+  TaskId tSumZ = addOnlineTask("r(alpha, x)Sum_M_z_hatM(x)", [&] {
+    vector<uint64_t> etaA_z_hatA_x = Polynomial::multiplyPolynomialByNumber(z_hatA, etaA, p);
+    vector<uint64_t> etaB_z_hatB_x = Polynomial::multiplyPolynomialByNumber(z_hatB, etaB, p);
+    vector<uint64_t> etaC_z_hatC_x = Polynomial::multiplyPolynomialByNumber(z_hatC, etaC, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(etaA_z_hatA_x, "etaA_z_hatA(x)"));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(etaB_z_hatB_x, "etaB_z_hatB(x)"));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(etaC_z_hatC_x, "etaC_z_hatC(x)"));
+
+    vector<uint64_t> Sum_M_eta_M_z_hat_M_x = Polynomial::addPolynomials(Polynomial::addPolynomials(etaA_z_hatA_x, etaB_z_hatB_x, p), etaC_z_hatC_x, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(Sum_M_eta_M_z_hat_M_x, "Sum_M_z_hatM(x)"));
+
+    vector<uint64_t> r_alpha_x = Polynomial::calculatePolynomial_r_alpha_x(alpha, n, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(r_alpha_x, "r(alpha, x)"));
+
+    r_Sum_x = Polynomial::multiplyPolynomialBy_r_alpha_x(Sum_M_eta_M_z_hat_M_x, alpha, n, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(r_Sum_x, "r(alpha, x)Sum_M_z_hatM(x)"));
+  }, { tZA, tZB, tZC, tRound1 }, 6 * polyBytesH);
+
+  TaskId tRAlphaH = addOfflineTask("r(alpha, H)", [&] {
+    r_alpha_H = Polynomial::calculatePolynomial_r_alpha_H(alpha, H, p);
+  }, { tRound1 }, polyBytesH);
+
+  // M_hat(x) for M in {A, B, C} from its nonzero entries (row, col, val) on K
+  auto M_hat_over_H = [&](const vector<uint64_t>& rowM, const vector<uint64_t>& colM, const vector<uint64_t>& valM, uint64_t count, [[maybe_unused]] const std::string& name) {
+    vector<uint64_t> M_hat_H(n, 0);
+    for (uint64_t i = 0; i < count; i++) {
+      uint64_t row = H_index.at(rowM[i]);
+      uint64_t col = H_index.at(colM[i]);
+      uint64_t eval = (r_h_h[row] * valM[i]) % p;
+      eval = (eval * r_alpha_H[row]) % p;
+      M_hat_H[col] = (M_hat_H[col] + eval * r_h_h[col]) % p;
+    }
+    vector<uint64_t> M_hat = Polynomial::interpolateOverH(M_hat_H, w, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(M_hat, name));
+    return M_hat;
+  };
+  TaskId tAHat = addOfflineTask("A_hat", [&] { A_hat = M_hat_over_H(rowA, colA, valA, nonZeroA.size(), "A_hat(x)"); }, { tRAlphaH }, 3 * polyBytesH);
+  TaskId tBHat = addOfflineTask("B_hat", [&] { B_hat = M_hat_over_H(rowB, colB, valB, nonZeroB.size(), "B_hat(x)"); }, { tRAlphaH }, 3 * polyBytesH);
+  TaskId tCHat = addOfflineTask("C_hat", [&] { C_hat = M_hat_over_H(rowC, colC, valC, n_g, "C_hat(x)"); }, { tRAlphaH }, 3 * polyBytesH);
+
+  TaskId tSumEtaMHat = addOfflineTask("Sum_M_eta_M_r_M(alpha, x)", [&] {
+    vector<uint64_t> eta_A_hat = Polynomial::multiplyPolynomialByNumber(A_hat, etaA, p);
+    vector<uint64_t> eta_B_hat = Polynomial::multiplyPolynomialByNumber(B_hat, etaB, p);
+    vector<uint64_t> eta_C_hat = Polynomial::multiplyPolynomialByNumber(C_hat, etaC, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_A_hat, "eta_A_hat: "));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_B_hat, "eta_B_hat: "));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_C_hat, "eta_C_hat: "));
+
+    // Calculate the sum of the three polynomials and print the result
+    Sum_M_eta_M_r_M_alpha_x = Polynomial::addPolynomials(Polynomial::addPolynomials(eta_A_hat, eta_B_hat, p), eta_C_hat, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(Sum_M_eta_M_r_M_alpha_x, "Sum_M_eta_M_r_M(alpha ,x)"));
+  }, { tAHat, tBHat, tCHat }, 3 * polyBytesH);
+
+  TaskId tSumcheck1 = addOnlineTask("h1, g1", [&] {
+    // Multiply the sum by another polynomial z_hat_x and print the result
+    vector<uint64_t> Sum_M_eta_M_r_M_alpha_x_z_hat_x = Polynomial::multiplyPolynomials(Sum_M_eta_M_r_M_alpha_x, z_hat_x, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(Sum_M_eta_M_r_M_alpha_x_z_hat_x, "Sum_M_eta_M_r_M(alpha ,x)z-hat(x)"));
+
+    // Calculate the sum for the check protocol, subtracting the pified sum from s_x
+    vector<uint64_t> Sum_check_protocol = Polynomial::addPolynomials(s_x, (Polynomial::subtractPolynomials(r_Sum_x, Sum_M_eta_M_r_M_alpha_x_z_hat_x, p)), p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(Sum_check_protocol, "Sum_check_protocol"));
+
+    // Divide the sum check protocol by vH_x to get two results: h1(x) and g1(x)
+    vector<vector<uint64_t>> Sum_check_protocol_div_vH = Polynomial::dividePolynomialByBinomial(Sum_check_protocol, n, 1, p);
+    h_1_x = Sum_check_protocol_div_vH[0];
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(h_1_x, "h1(x)"));
+
+    // Get the second part of the division result, g1(x), and erase the first element
+    g_1_x = Sum_check_protocol_div_vH[1];
+    g_1_x.erase(g_1_x.begin());
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(g_1_x, "g1(x)"));
+  }, { tSumEtaMHat, tZHat, tSumZ }, 8 * polyBytesH);
+
+  // Second sumcheck
+  phase = "sumcheck 2";
+  TaskId tSigma2 = addOfflineTask("sigma2", [&] {
+    // Calculate sigma2 using the evaluations of the polynomials A_hat, B_hat, and C_hat and print the result of sigma2
+    sigma2 = ((etaA * Polynomial::evaluatePolynomial(A_hat, beta1, p)) % p + (etaB * Polynomial::evaluatePolynomial(B_hat, beta1, p)) % p + (etaC * Polynomial::evaluatePolynomial(C_hat, beta1, p)) % p) % p;
+    FIDES_LOG_DEBUG(cout << "sigma2 = " << sigma2 << endl);
+  }, { tAHat, tBHat, tCHat, tRound2 });
+
+  // M_hat(x, beta1) = sum val * r(col, beta1) * r(row, x) is scattered over H the same way, at the row points
+  TaskId tRBeta1H = addOfflineTask("r(beta1, H)", [&] {
+    r_beta1_H = Polynomial::calculatePolynomial_r_alpha_H(beta1, H, p);
+  }, { tRound2 }, polyBytesH);
+
+  auto M_hat_beta1_over_H = [&](const vector<uint64_t>& rowM, const vector<uint64_t>& colM, const vector<uint64_t>& valM, uint64_t count, [[maybe_unused]] const std::string& name) {
+    vector<uint64_t> M_hat_M_hat_H(n, 0);
+    for (uint64_t i = 0; i < count; i++) {
+      uint64_t row = H_index.at(rowM[i]);
+      uint64_t eval = (r_beta1_H[H_index.at(colM[i])] * valM[i]) % p;
+      M_hat_M_hat_H[row] = (M_hat_M_hat_H[row] + eval * r_h_h[row]) % p;
+    }
+    vector<uint64_t> M_hat_M_hat = Polynomial::interpolateOverH(M_hat_M_hat_H, w, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(M_hat_M_hat, name));
+    return M_hat_M_hat;
+  };
+  TaskId tAHatM = addOfflineTask("A_hat_M_hat", [&] { A_hat_M_hat = M_hat_beta1_over_H(rowA, colA, valA, nonZeroA.size(), "A_hat_M_hat"); }, { tRBeta1H }, 3 * polyBytesH);
+  TaskId tBHatM = addOfflineTask("B_hat_M_hat", [&] { B_hat_M_hat = M_hat_beta1_over_H(rowB, colB, valB, nonZeroB.size(), "B_hat_M_hat"); }, { tRBeta1H }, 3 * polyBytesH);
+  TaskId tCHatM = addOfflineTask("C_hat_M_hat", [&] { C_hat_M_hat = M_hat_beta1_over_H(rowC, colC, valC, n_g, "C_hat_M_hat"); }, { tRBeta1H }, 3 * polyBytesH);
+
+  TaskId tSumcheck2 = addOfflineTask("h2, g2", [&] {
+    // Multiply the pified polynomials by their respective eta values and print
+    vector<uint64_t> eta_A_hat_M_hat = Polynomial::multiplyPolynomialByNumber(A_hat_M_hat, etaA, p);
+    vector<uint64_t> eta_B_hat_M_hat = Polynomial::multiplyPolynomialByNumber(B_hat_M_hat, etaB, p);
+    vector<uint64_t> eta_C_hat_M_hat = Polynomial::multiplyPolynomialByNumber(C_hat_M_hat, etaC, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_A_hat_M_hat, "eta_A_hat_M_hat: "));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_B_hat_M_hat, "eta_B_hat_M_hat: "));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(eta_C_hat_M_hat, "eta_C_hat_M_hat: "));
+
+    // Calculate the final result for r_Sum_M_eta_M_M_hat_x_beta1
+    vector<uint64_t> r_Sum_M_eta_M_M_hat_x_beta1 = Polynomial::multiplyPolynomialBy_r_alpha_x(Polynomial::addPolynomials(Polynomial::addPolynomials(eta_A_hat_M_hat, eta_B_hat_M_hat, p), eta_C_hat_M_hat, p), alpha, n, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(r_Sum_M_eta_M_M_hat_x_beta1, "r_Sum_M_eta_M_M_hat_x_beta1"));
+
+    // Divide the final result by vH_x to get h2(x) and g2(x)
+    vector<vector<uint64_t>> r_Sum_M_eta_M_M_hat_x_beta1_div_vH = Polynomial::dividePolynomialByBinomial(r_Sum_M_eta_M_M_hat_x_beta1, n, 1, p);
+    h_2_x = r_Sum_M_eta_M_M_hat_x_beta1_div_vH[0];
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(h_2_x, "h2(x)"));
+
+    g_2_x = r_Sum_M_eta_M_M_hat_x_beta1_div_vH[1];
+    g_2_x.erase(g_2_x.begin());//remove the first item
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(g_2_x, "g2(x)"));
+  }, { tAHatM, tBHatM, tCHatM, tRound1 }, 8 * polyBytesH);
+
+  // Third sumcheck
+  phase = "sumcheck 3";
+  TaskId tSigma3 = addOfflineTask("sigma3", [&] {
+    // Evaluate polynomial vH at beta1 and beta2
+    vH_beta1 = Polynomial::evaluatePolynomial(vH_x, beta1, p);
+    FIDES_LOG_DEBUG(cout << "vH(beta1) = " << vH_beta1 << endl);
+
+    vH_beta2 = Polynomial::evaluatePolynomial(vH_x, beta2, p);
+    FIDES_LOG_DEBUG(cout << "vH(beta2) = " << vH_beta2 << endl);
+
+    // rowM_x, colM_x and valM_x interpolate the K-domain mappings stored in program_param.json,
+    // so rowM_x(K[i]) = rowM[i], colM_x(K[i]) = colM[i] and valM_x(K[i]) = valM[i]
+    vector<uint64_t> deA(K.size(), 0);
+    vector<uint64_t> deB(K.size(), 0);
+    vector<uint64_t> deC(K.size(), 0);
+    for (uint64_t i = 0; i < K.size(); i++) {
+      deA[i] = (Polynomial::subtractModP(beta2, rowA[i], p) * Polynomial::subtractModP(beta1, colA[i], p)) % p;
+      deB[i] = (Polynomial::subtractModP(beta2, rowB[i], p) * Polynomial::subtractModP(beta1, colB[i], p)) % p;
+      deC[i] = (Polynomial::subtractModP(beta2, rowC[i], p) * Polynomial::subtractModP(beta1, colC[i], p)) % p;
+    }
+    vector<uint64_t> deA_inv = Polynomial::batchInverse(deA, p);
+    vector<uint64_t> deB_inv = Polynomial::batchInverse(deB, p);
+    vector<uint64_t> deC_inv = Polynomial::batchInverse(deC, p);
+
+    uint64_t etaA_vH_B2_vH_B1 = (etaA * (vH_beta2 * vH_beta1 % p)) % p;
+    uint64_t etaB_vH_B2_vH_B1 = (etaB * (vH_beta2 * vH_beta1 % p)) % p;
+    uint64_t etaC_vH_B2_vH_B1 = (etaC * (vH_beta2 * vH_beta1 % p)) % p;
+
+    // Loop over K to compute signature values for A, B, and C
+    for (uint64_t i = 0; i < K.size(); i++) {
+      uint64_t sig3_A = (etaA_vH_B2_vH_B1 * valA[i] % p * deA_inv[i]) % p;
+      uint64_t sig3_B = (etaB_vH_B2_vH_B1 * valB[i] % p * deB_inv[i]) % p;
+      uint64_t sig3_C = (etaC_vH_B2_vH_B1 * valC[i] % p * deC_inv[i]) % p;
+
+      points_f_3[i] = (sig3_A + sig3_B + sig3_C) % p;
+      sigma3 += points_f_3[i];
+      sigma3 %= p;
+    }
+    FIDES_LOG_DEBUG(cout << "sigma3 = " << sigma3 << endl);
+  }, { tRound1, tRound2, tRound3 }, 3 * polyBytesK);
+
+  // Compute polynomial products for sigma
+  auto poly_pi = [&](const vector<uint64_t>& rowM_x, const vector<uint64_t>& colM_x, [[maybe_unused]] const std::string& name) {
+    vector<uint64_t> poly_beta1 = { beta1 };
+    vector<uint64_t> poly_beta2 = { beta2 };
+    vector<uint64_t> poly_pi_m = Polynomial::multiplyPolynomials(Polynomial::subtractPolynomials(rowM_x, poly_beta2, p), Polynomial::subtractPolynomials(colM_x, poly_beta1, p), p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(poly_pi_m, name));
+    return poly_pi_m;
+  };
+  TaskId tPiA = addOfflineTask("poly_pi_a", [&] { poly_pi_a = poly_pi(rowA_x, colA_x, "poly_pi_a"); }, { tRound2, tRound3 }, 2 * polyBytesK);
+  TaskId tPiB = addOfflineTask("poly_pi_b", [&] { poly_pi_b = poly_pi(rowB_x, colB_x, "poly_pi_b"); }, { tRound2, tRound3 }, 2 * polyBytesK);
+  TaskId tPiC = addOfflineTask("poly_pi_c", [&] { poly_pi_c = poly_pi(rowC_x, colC_x, "poly_pi_c"); }, { tRound2, tRound3 }, 2 * polyBytesK);
+
+  TaskId tPiBC = addOfflineTask("poly_pi_b * poly_pi_c", [&] { poly_pi_bc = Polynomial::multiplyPolynomials(poly_pi_b, poly_pi_c, p); }, { tPiB, tPiC }, 2 * polyBytesK);
+  TaskId tPiAC = addOfflineTask("poly_pi_a * poly_pi_c", [&] { poly_pi_ac = Polynomial::multiplyPolynomials(poly_pi_a, poly_pi_c, p); }, { tPiA, tPiC }, 2 * polyBytesK);
+  TaskId tPiAB = addOfflineTask("poly_pi_a * poly_pi_b", [&] { poly_pi_ab = Polynomial::multiplyPolynomials(poly_pi_a, poly_pi_b, p); }, { tPiA, tPiB }, 2 * polyBytesK);
+
+  TaskId tAX = addOfflineTask("a(x)", [&] {
+    // Compute polynomials for signature multipliers
+    vector<uint64_t> poly_etaA_vH_B2_vH_B1 = { (etaA * ((vH_beta2 * vH_beta1) % p)) % p };
+    vector<uint64_t> poly_etaB_vH_B2_vH_B1 = { (etaB * ((vH_beta2 * vH_beta1) % p)) % p };
+    vector<uint64_t> poly_etaC_vH_B2_vH_B1 = { (etaC * ((vH_beta2 * vH_beta1) % p)) % p };
+
+    // Calculate sigma
+    vector<uint64_t> poly_sig_a = Polynomial::multiplyPolynomials(poly_etaA_vH_B2_vH_B1, valA_x, p);
+    vector<uint64_t> poly_sig_b = Polynomial::multiplyPolynomials(poly_etaB_vH_B2_vH_B1, valB_x, p);
+    vector<uint64_t> poly_sig_c = Polynomial::multiplyPolynomials(poly_etaC_vH_B2_vH_B1, valC_x, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(poly_sig_a, "poly_sig_a"));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(poly_sig_b, "poly_sig_b"));
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(poly_sig_c, "poly_sig_c"));
+
+    a_x = Polynomial::addPolynomials(Polynomial::addPolynomials(Polynomial::multiplyPolynomials(poly_sig_a, poly_pi_bc, p), Polynomial::multiplyPolynomials(poly_sig_b, poly_pi_ac, p), p), Polynomial::multiplyPolynomials(poly_sig_c, poly_pi_ab, p), p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(a_x, "a(x)"));
+  }, { tPiBC, tPiAC, tPiAB, tSigma3 }, 12 * polyBytesK);
+
+  TaskId tBX = addOfflineTask("b(x)", [&] {
+    b_x = Polynomial::multiplyPolynomials(poly_pi_ab, poly_pi_c, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(b_x, "b(x)"));
+  }, { tPiAB, tPiC }, 3 * polyBytesK);
+
+  TaskId tF3 = addOfflineTask("g3, f3", [&] {
+    // Set up polynomial for f_3 using K
+    vector<uint64_t> poly_f_3x = Polynomial::setupNewtonPolynomial(K, points_f_3, p, "poly_f_3(x)");
+
+    g_3_x = poly_f_3x;
+    g_3_x.erase(g_3_x.begin());
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(g_3_x, "g3(x)"));
+
+    // Calculate sigma_3_set_k based on sigma3 and K.size()
+    sigma_3_set_k.push_back((sigma3 * Polynomial::pInverse(K.size(), p)) % p);
+    FIDES_LOG_DEBUG(cout << "sigma_3_set_k = " << sigma_3_set_k[0] << endl);
+
+    // Update polynomial f_3 by subtracting sigma_3_set_k
+    poly_f_3x_new = Polynomial::subtractPolynomials(poly_f_3x, sigma_3_set_k, p);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(poly_f_3x_new, "f3(x)new"));
+  }, { tSigma3 }, 4 * polyBytesK);
+
+  TaskId tH3 = addOfflineTask("h3", [&] {
+    // Calculate polynomial h_3(x) using previous results
+    h_3_x = Polynomial::dividePolynomialByBinomial(Polynomial::subtractPolynomials(a_x, Polynomial::multiplyPolynomials(b_x, Polynomial::addPolynomials(poly_f_3x_new, sigma_3_set_k, p), p), p), m, 1, p)[0];
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(h_3_x, "h3(x)"));
+  }, { tAX, tBX, tF3 }, 12 * polyBytesK);
+
+  // Opening of the combined polynomial p(x) at x_prime. p(x) weights every committed polynomial with its eta
+  // and sums them; the index, s and second and third sumcheck terms are summed offline, the witness terms online
+  phase = "opening";
+  const vector<uint64_t>* p_x_terms[21] = {
+    &rowA_x, &colA_x, &valA_x, &rowB_x, &colB_x, &valB_x, &rowC_x, &colC_x, &valC_x,
+    &w_hat_x, &z_hatA, &z_hatB, &z_hatC, &h_0_x, &s_x, &g_1_x, &h_1_x, &g_2_x, &h_2_x, &g_3_x, &h_3_x
+  };
+  const bool p_x_term_online[21] = {
+    false, false, false, false, false, false, false, false, false,
+    true, true, true, true, true, false, true, true, false, false, false, false
+  };
+  auto sum_p_x_terms = [&](vector<uint64_t> sum, bool termsOnline) {
+    for (uint64_t i = 0; i < 21; i++) {
+      if (p_x_term_online[i] == termsOnline) {
+        sum = Polynomial::addPolynomials(sum, Polynomial::multiplyPolynomialByNumber(*p_x_terms[i], eta_p[i], p), p);
+      }
+    }
+    return sum;
+  };
+  TaskId tPXOffline = addOfflineTask("p(x) offline terms", [&] {
+    p_x_offline = sum_p_x_terms({}, false);
+  }, { tS, tSumcheck2, tF3, tH3, tRound4 }, polyBytesH + 12 * polyBytesK);
+
+  TaskId tPX = addOpeningTask("p(x), q(x)", [&] {
+    vector<uint64_t> p_x = sum_p_x_terms(p_x_offline, true);
+    FIDES_LOG_DEBUG(Polynomial::printPolynomial(p_x, "p(x)"));
+
+    // Open p(x) at x_prime: y' = p(x'), and p_17_AHP commits to q(x) = (p(x) - y') / (x - x')
+    CommitmentBackend::Opening opening = backend.open({ &p_x }, { 1 }, x_prime);
+    y_prime = backend.value(opening.values[0]);
+    FIDES_LOG_DEBUG(cout << "y_prime = " << y_prime << endl);
+    p_17_AHP = backend.value(opening.proof);
+    FIDES_LOG_DEBUG(cout << "p_17_AHP = " << p_17_AHP << endl);
+  }, { tWHat, tZA, tZB, tZC, tH0, tSumcheck1, tPXOffline }, 2 * polyBytesH);
+
+  // Generate KZG commitments for various polynomials, each as soon as its polynomial is final
+  phase = "commitments";
+  const vector<uint64_t>* Com_AHP_poly[14] = {
+    nullptr, nullptr, &w_hat_x, &z_hatA, &z_hatB, &z_hatC, &h_0_x, &s_x, &g_1_x, &h_1_x, &g_2_x, &h_2_x, &g_3_x, &h_3_x
+  };
+  TaskId Com_AHP_producer[14] = {
+    0, 0, tWHat, tZA, tZB, tZC, tH0, tS, tSumcheck1, tSumcheck1, tSumcheck2, tSumcheck2, tF3, tH3
+  };
+  TaskId tCom[14] = { 0, 0 };
+  for (uint64_t i = 2; i < 14; i++) {
+    auto commit = [&, i] {
+      Com_AHP_x[i] = backend.value(backend.commit(*Com_AHP_poly[i]));
+    };
+    // s, g2, h2, g3 and h3 are committed offline
+    if (i == 7 || i >= 10) {
+      tCom[i] = addOfflineTask("Com" + to_string(i) + "_AHP_x", commit, { Com_AHP_producer[i] });
+    } else {
+      tCom[i] = addOnlineTask("Com" + to_string(i) + "_AHP_x", commit, { Com_AHP_producer[i] });
+    }
+  }
+
+  phase = "opening";
+  // A succinct proof sends evaluations and openings instead of the polynomials: s(x) at the points the challenges
+  // are hashed from, opened at once as (s(x) - I_s(x)) / Z_s(x) with I_s interpolating them and Z_s vanishing on
+  // them, and every other polynomial at the point its check reads it. The polynomials of a point are opened
+  // together, weighted with powers of a challenge hashed from the point, their commitments and their evaluations
+  vector<uint64_t> s_points, at_beta1, at_beta2, at_beta3;
+  uint64_t beta3 = 0, W_s = 0, W_beta1 = 0, W_beta2 = 0, W_beta3 = 0;
+  TaskId tOpenings = addOpeningTask("succinct openings", [&] {
+    vector<uint64_t> points, Z_s = { 1 };
+    for (uint64_t k = 0; k < ProofCodec::SUCCINCT_S_POINTS; k++) {
+      points.push_back(k);
+      s_points.push_back(Polynomial::evaluatePolynomial(s_x, k, p));
+      Z_s = Polynomial::multiplyPolynomials(Z_s, { (p - k) % p, 1 }, p);
+    }
+    vector<uint64_t> I_s = Polynomial::setupNewtonPolynomial(points, s_points, p, "I_s(x)");
+    W_s = backend.value(backend.commit(Polynomial::dividePolynomials(Polynomial::subtractPolynomials(s_x, I_s, p), Z_s, p)[0]));
+
+    // The verifier of a full proof draws beta3 itself; a succinct proof is opened at beta3, so it is hashed from a
+    // transcript of s(31) and the commitments of g3 and h3. Taken after g3 and h3 are committed, it cannot be known
+    // when they are chosen, as it could be from s(31) alone
+    beta3 = Polynomial::hashTranscript({ s_points[ProofCodec::SUCCINCT_S_POINTS - 1], Com_AHP_x[12], Com_AHP_x[13] }, p);
+    FIDES_LOG_DEBUG(cout << "beta3 = " << beta3 << endl);
+
+    // eta_p is known before the evaluations are claimed, so it would let a prover shift two of them unnoticed
+    auto open = [&](const vector<uint64_t>& terms, uint64_t point, vector<uint64_t>& values) {
+      vector<const vector<uint64_t>*> polys;
+      vector<uint64_t> commitments;
+      for (uint64_t i : terms) {
+        polys.push_back(p_x_terms[i]);
+        commitments.push_back(i < 9 ? keys.Com_AHP[i] : Com_AHP_x[i - 7]);
+        values.push_back(Polynomial::evaluatePolynomial(*p_x_terms[i], point, p));
+      }
+      vector<uint64_t> weights = Polynomial::openingWeights(point, commitments, values, p);
+      return backend.value(backend.open(polys, weights, point).proof);
+    };
+    W_beta1 = open({ 9, 10, 11, 12, 13, 14, 15, 16 }, beta1, at_beta1);
+    W_beta2 = open({ 17, 18 }, beta2, at_beta2);
+    W_beta3 = open({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 19, 20 }, beta3, at_beta3);
+  }, { tWHat, tZA, tZB, tZC, tH0, tS, tSumcheck1, tSumcheck2, tF3, tH3, tRound2, tRound3, tRound4,
+       tCom[2], tCom[3], tCom[4], tCom[5], tCom[6], tCom[7], tCom[8], tCom[9], tCom[10], tCom[11], tCom[12], tCom[13] }, 3 * polyBytesH, true);
+
+  // The witness-independent material as a ProverOffline, for a stored set or the offline checkpoint
+  auto offlineState = [&] {
+    ProverOffline state;
+    state.commitmentID = keys.commitmentID;
+    state.b = b;
+    state.maskA = maskA;
+    state.maskB = maskB;
+    state.maskC = maskC;
+    state.mask_w = mask_w;
+    state.s_x = s_x;
+    state.sigma1 = sigma1;
+    state.alpha = alpha;
+    state.etaA = etaA;
+    state.etaB = etaB;
+    state.etaC = etaC;
+    state.beta1 = beta1;
+    state.beta2 = beta2;
+    state.x_prime = x_prime;
+    state.eta_p = eta_p;
+    state.Sum_M_eta_M_r_M_alpha_x = Sum_M_eta_M_r_M_alpha_x;
+    state.sigma2 = sigma2;
+    state.sigma3 = sigma3;
+    state.g_2_x = g_2_x;
+    state.h_2_x = h_2_x;
+    state.g_3_x = g_3_x;
+    state.h_3_x = h_3_x;
+    state.p_x_offline = p_x_offline;
+    state.Com_AHP_x = Com_AHP_x;
+    state.ready = true;
+    return state;
+  };
+
+  // A checkpointed proof writes the offline part once it is complete, then sumcheck 1 and the witness phases
+  // before it; each file is renamed into place, so an interruption while writing leaves the previous state
+  phase = "checkpoints";
+  TaskId tCheckpointOffline = tSkipped;
+  TaskId tCheckpointSumcheck1 = tSkipped;
+  if (checkpoint && !resumedOffline) {
+    tCheckpointOffline = addTask("checkpoint offline", [&] {
+      writeOfflineFile(checkpointDirectory, offlineCheckpoint, offlineState());
+    }, { tRound1, tRound2, tRound3, tSumEtaMHat, tSigma2, tSigma3, tPXOffline, tCom[7], tCom[10], tCom[11], tCom[12], tCom[13] });
+  }
+  if (checkpoint && !witnessDone) {
+    tCheckpointSumcheck1 = addTask("checkpoint sumcheck 1", [&] {
+      writeValuesFile(checkpointDirectory, sumcheck1Checkpoint, [&](OfflineWriter& writer) {
+        uint64_t magic = SUMCHECK1_CHECKPOINT_MAGIC;
+        vector<uint64_t> id(keys.commitmentID.begin(), keys.commitmentID.end());
+        writer.value(magic);
+        writer.values(id);
+        writer.values(z);
+        writer.values(w_hat_x);
+        writer.values(z_hatA);
+        writer.values(z_hatB);
+        writer.values(z_hatC);
+        writer.values(h_0_x);
+        writer.values(g_1_x);
+        writer.values(h_1_x);
+        writer.values(Com_AHP_x);
+      });
+    }, { tCheckpointOffline, tWHat, tZA, tZB, tZC, tH0, tSumcheck1, tCom[2], tCom[3], tCom[4], tCom[5], tCom[6], tCom[8], tCom[9] });
+  }
+
+  // Release every intermediate once its last consumer has run
+  phase = "memory";
+  auto releaseAfter = [&](vector<uint64_t>& poly, const vector<TaskId>& consumers) {
+    addTask("release", [&poly] { releasePolynomial(poly); }, consumers);
+  };
+  releaseAfter(Az, { tZA });
+  releaseAfter(Bz, { tZB });
+  releaseAfter(Cz, { tZC });
+  releaseAfter(polyX_HAT_H, { tWHat, tZHat });
+  releaseAfter(z_hat_x, { tSumcheck1 });
+  releaseAfter(r_Sum_x, { tSumcheck1 });
+  releaseAfter(r_alpha_H, { tAHat, tBHat, tCHat });
+  releaseAfter(A_hat, { tSumEtaMHat, tSigma2 });
+  releaseAfter(B_hat, { tSumEtaMHat, tSigma2 });
+  releaseAfter(C_hat, { tSumEtaMHat, tSigma2 });
+  releaseAfter(r_beta1_H, { tAHatM, tBHatM, tCHatM });
+  releaseAfter(A_hat_M_hat, { tSumcheck2 });
+  releaseAfter(B_hat_M_hat, { tSumcheck2 });
+  releaseAfter(C_hat_M_hat, { tSumcheck2 });
+  releaseAfter(points_f_3, { tF3 });
+  releaseAfter(poly_pi_a, { tPiAC, tPiAB });
+  releaseAfter(poly_pi_b, { tPiBC, tPiAB });
+  releaseAfter(poly_pi_c, { tPiBC, tPiAC, tBX });
+  releaseAfter(poly_pi_bc, { tAX });
+  releaseAfter(poly_pi_ac, { tAX });
+  releaseAfter(poly_pi_ab, { tAX, tBX });
+  releaseAfter(a_x, { tH3 });
+  releaseAfter(b_x, { tH3 });
+  releaseAfter(poly_f_3x_new, { tH3 });
+  if (online) {
+    releaseAfter(Sum_M_eta_M_r_M_alpha_x, { tSumcheck1, tCheckpointOffline });
+    releaseAfter(p_x_offline, { tPX, tCheckpointOffline });
+  }
+
+  // Under a memory budget the proof polynomials wait on disk between their last consumer and serialization.
+  // A unique tag keeps the files of concurrent proofs apart
+  std::string spillTag = uniqueFileTag();
+  vector<pair<vector<uint64_t>*, std::string>> spilled;
+  auto spillAfter = [&](vector<uint64_t>& poly, const std::string& name, const vector<TaskId>& consumers) {
+    if (memoryBudget == 0) {
+      return;
+    }
+    std::string path = keys.directory + "/data/" + name + "_" + spillTag + ".spill";
+    spilled.push_back({ &poly, path });
+    addTask("spill " + name, [&poly, path] { spillPolynomial(poly, path); }, consumers);
+  };
+  spillAfter(w_hat_x, "w_hat", { tZHat, tPX, tOpenings, tCom[2], tCheckpointSumcheck1 });
+  spillAfter(z_hatA, "z_hatA", { tH0, tSumZ, tPX, tOpenings, tCom[3], tCheckpointSumcheck1 });
+  spillAfter(z_hatB, "z_hatB", { tH0, tSumZ, tPX, tOpenings, tCom[4], tCheckpointSumcheck1 });
+  spillAfter(z_hatC, "z_hatC", { tH0, tSumZ, tPX, tOpenings, tCom[5], tCheckpointSumcheck1 });
+  spillAfter(h_0_x, "h_0", { tPX, tOpenings, tCom[6], tCheckpointSumcheck1 });
+  spillAfter(s_x, "s", { tRound1, tRound2, tRound3, tRound4, tSumcheck1, tPX, tOpenings, tCom[7], tCheckpointOffline });
+  spillAfter(g_1_x, "g_1", { tPX, tOpenings, tCom[8], tCheckpointSumcheck1 });
+  spillAfter(h_1_x, "h_1", { tPX, tOpenings, tCom[9], tCheckpointSumcheck1 });
+  spillAfter(g_2_x, "g_2", { tPX, tOpenings, tCom[10], tCheckpointOffline });
+  spillAfter(h_2_x, "h_2", { tPX, tOpenings, tCom[11], tCheckpointOffline });
+  spillAfter(g_3_x, "g_3", { tPX, tOpenings, tCom[12], tCheckpointOffline });
+  spillAfter(h_3_x, "h_3", { tPX, tOpenings, tCom[13], tCheckpointOffline });
+
+  if (index + 1 < end) {
+    proveFrom(graph, keys, jobs, index + 1, end, memoryBudget, proofs);
+  } else {
+    graph.run();
+  }
+
+  ProverMetrics::Scope unspillScope("memory");
+  for (auto& entry : spilled) {
+    unspillPolynomial(*entry.first, entry.second);
+  }
+  unspillScope.stop();
+
+  if (!online) {
+    *job.offline = offlineState();
+    return;
+  }
+
+  vector<uint64_t> Com1_AHP_x;
+  for (int i = 1; i < 33; i++) {
+    Com1_AHP_x.push_back(z[i]);
+  }
+  uint64_t Com2_AHP_x = Com_AHP_x[2];
+  uint64_t Com3_AHP_x = Com_AHP_x[3];
+  uint64_t Com4_AHP_x = Com_AHP_x[4];
+  uint64_t Com5_AHP_x = Com_AHP_x[5];
+  uint64_t Com6_AHP_x = Com_AHP_x[6];
+  uint64_t Com7_AHP_x = Com_AHP_x[7];
+  uint64_t Com8_AHP_x = Com_AHP_x[8];
+  uint64_t Com9_AHP_x = Com_AHP_x[9];
+  uint64_t Com10_AHP_x = Com_AHP_x[10];
+  uint64_t Com11_AHP_x = Com_AHP_x[11];
+  uint64_t Com12_AHP_x = Com_AHP_x[12];
+  uint64_t Com13_AHP_x = Com_AHP_x[13];
+
+  FIDES_LOG_DEBUG(cout << "Com2_AHP_x = " << Com2_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com3_AHP_x = " << Com3_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com4_AHP_x = " << Com4_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com5_AHP_x = " << Com5_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com6_AHP_x = " << Com6_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com7_AHP_x = " << Com7_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com8_AHP_x = " << Com8_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com9_AHP_x = " << Com9_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com10_AHP_x = " << Com10_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com11_AHP_x = " << Com11_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com12_AHP_x = " << Com12_AHP_x << endl);
+  FIDES_LOG_DEBUG(cout << "Com13_AHP_x = " << Com13_AHP_x << endl);
+
+  // Generate a KZG commitment for the combined polynomial p(x)
+  // int64_t ComP_AHP_x = Polynomial::KZG_Commitment(ck, p_x, p);
+  // cout << "ComP_AHP = " << ComP_AHP_x << endl;
+
+  ProofCodec::Proof proof;
+  proof.commitmentId = keys.commitmentID;
+  proof.Class = keys.Class;
+  proof.succinct = succinct;
+  proof.entries["P_AHP1"] = { sigma1 };
+  proof.entries["P_AHP10"] = { sigma2 };
+  proof.entries["P_AHP13"] = { sigma3 };
+  if (succinct) {
+    proof.entries["P_AHP18"] = s_points;
+    proof.entries["P_AHP19"] = { W_s };
+    proof.entries["P_AHP20"] = at_beta1;
+    proof.entries["P_AHP21"] = at_beta2;
+    proof.entries["P_AHP22"] = at_beta3;
+    proof.entries["P_AHP23"] = { W_beta1 };
+    proof.entries["P_AHP24"] = { W_beta2 };
+    proof.entries["P_AHP25"] = { W_beta3 };
+  } else {
+    proof.entries["P_AHP2"] = w_hat_x;
+    proof.entries["P_AHP3"] = z_hatA;
+    proof.entries["P_AHP4"] = z_hatB;
+    proof.entries["P_AHP5"] = z_hatC;
+    proof.entries["P_AHP6"] = h_0_x;
+    proof.entries["P_AHP7"] = s_x;
+    proof.entries["P_AHP8"] = g_1_x;
+    proof.entries["P_AHP9"] = h_1_x;
+    proof.entries["P_AHP11"] = g_2_x;
+    proof.entries["P_AHP12"] = h_2_x;
+    proof.entries["P_AHP14"] = g_3_x;
+    proof.entries["P_AHP15"] = h_3_x;
+    proof.entries["P_AHP16"] = { y_prime };
+    proof.entries["P_AHP17"] = { p_17_AHP };
+  }
+  proof.entries["Com_AHP1_x"] = Com1_AHP_x;
+  proof.entries["Com_AHP2_x"] = { Com2_AHP_x };
+  proof.entries["Com_AHP3_x"] = { Com3_AHP_x };
+  proof.entries["Com_AHP4_x"] = { Com4_AHP_x };
+  proof.entries["Com_AHP5_x"] = { Com5_AHP_x };
+  proof.entries["Com_AHP6_x"] = { Com6_AHP_x };
+  proof.entries["Com_AHP7_x"] = { Com7_AHP_x };
+  proof.entries["Com_AHP8_x"] = { Com8_AHP_x };
+  proof.entries["Com_AHP9_x"] = { Com9_AHP_x };
+  proof.entries["Com_AHP10_x"] = { Com10_AHP_x };
+  proof.entries["Com_AHP11_x"] = { Com11_AHP_x };
+  proof.entries["Com_AHP12_x"] = { Com12_AHP_x };
+  proof.entries["Com_AHP13_x"] = { Com13_AHP_x };
+  // proof.entries["ComP_AHP_x"] = { ComP_AHP_x };
+
+  // The checkpoints are removed before the proof is returned, so a complete proof never leaves one behind
+  if (checkpoint) {
+    std::remove((checkpointDirectory + "/" + offlineCheckpoint).c_str());
+    std::remove(sumcheck1Path.c_str());
+  }
+
+  proofs[index] = std::move(proof);
+}
+
+ProofCodec::Proof Prover::prove(const ProverKeys& keys, const uint64_t* witness, size_t count, uint64_t memoryBudget, ProverOffline* offline, bool checkpoint, bool succinct) {
+  if (witness == nullptr) {
+    throw std::runtime_error("Error: Fides prover needs a witness");
+  }
+  vector<ProofCodec::Proof> proofs(1);
+  TaskGraph graph;
+  graph.setMemoryBudget(memoryBudget);
+  proveFrom(graph, keys, { { witness, count, offline != nullptr && offline->ready ? offline : nullptr, checkpoint, succinct } }, 0, 1, memoryBudget, proofs);
+  return proofs[0];
+}
+
+ProofCodec::Proof Prover::prove(const ProverKeys& keys, const vector<uint64_t>& witness, uint64_t memoryBudget, ProverOffline* offline, bool checkpoint, bool succinct) {
+  return prove(keys, witness.data(), witness.size(), memoryBudget, offline, checkpoint, succinct);
+}
+
+void Prover::checkWitness(const ProverKeys& keys, const uint64_t* witness, size_t count) {
+  const uint64_t p = keys.p;
+  const uint64_t first = keys.n_i + 1;
+  const uint64_t gates = keys.nonZeroA.size();
+  if (witness == nullptr || count < first + keys.n_g) {
+    throw std::runtime_error("Error: Fides prover needs " + to_string(first + keys.n_g) + " witness values, got " + to_string(count));
+  }
+  // Only the gate rows can fail: A and C are zero on the rows of the inputs. Row i + n_i + 1 of A and C holds a
+  // single 1, so only Bz is accumulated
+  vector<uint64_t> Bz(gates, 0);
+  for (const auto& entry : keys.nonZeroB) {
+    uint64_t row = entry[0];
+    if (row >= first && row < first + gates) {
+      Bz[row - first] = (Bz[row - first] + (entry[2] % p) * (witness[entry[1]] % p)) % p;
+    }
+  }
+  for (uint64_t i = 0; i < gates; i++) {
+    uint64_t Az = witness[keys.nonZeroA[i]] % p;
+    uint64_t Cz = witness[keys.nonZeroC[i]] % p;
+    if ((Az * Bz[i]) % p != Cz) {
+      std::string line = keys.line == 0 ? "" : " (line " + to_string(keys.line + i) + " of the assembly)";
+      throw std::runtime_error("Error: Fides witness does not satisfy gate " + to_string(i) + line + ": Az * Bz = " +
+                               to_string((Az * Bz[i]) % p) + ", Cz = " + to_string(Cz));
+    }
+  }
+}
+
+ProverOffline Prover::precompute(const ProverKeys& keys, uint64_t memoryBudget) {
+  ProverOffline offline;
+  vector<ProofCodec::Proof> proofs(1);
+  TaskGraph graph;
+  graph.setMemoryBudget(memoryBudget);
+  proveFrom(graph, keys, { { nullptr, 0, &offline, false, false } }, 0, 1, memoryBudget, proofs);
+  return offline;
+}
+
+void Prover::storeOffline(const ProverKeys& keys, const ProverOffline& offline) {
+  if (!offline.ready || offline.commitmentID != keys.commitmentID) {
+    throw std::runtime_error("Error: Fides offline set does not belong to commitment " + keys.commitmentID);
+  }
+  writeOfflineFile(keys.directory + "/data", offlinePrefix(keys) + uniqueFileTag() + ".bin", offline);
+}
+
+bool Prover::takeOffline(const ProverKeys& keys, ProverOffline& offline) {
+  for (const std::string& name : offlineFiles(keys)) {
+    // Renaming claims the set, so two provers sharing the directory never use the same masks
+    std::string path = keys.directory + "/data/" + name;
+    std::string claimed = keys.directory + "/data/.taken_" + uniqueFileTag() + "_" + name;
+    if (rename(path.c_str(), claimed.c_str()) != 0) {
+      continue;
+    }
+    ProverOffline loaded;
+    try {
+      loaded = readOfflineFile(keys, claimed);
+    } catch (const std::exception& error) {
+      FIDES_LOG_ERROR(cerr << error.what() << "; skipping it" << endl);
+      std::remove(claimed.c_str());
+      continue;
+    }
+    std::remove(claimed.c_str());
+    offline = std::move(loaded);
+    return true;
+  }
+  return false;
+}
+
+size_t Prover::offlineCount(const ProverKeys& keys) {
+  return offlineFiles(keys).size();
+}
+
+size_t Prover::offlinePoolFromEnv() {
+  if (getenv("FIDESINNOVA_OFFLINE_POOL") == nullptr) {
+    return 0;
+  }
+  return strtoull(getenv("FIDESINNOVA_OFFLINE_POOL"), nullptr, 10);
+}
+
+void Prover::refillOffline(const ProverKeys& keys, const function<bool()>& ready) {
+  size_t pool = offlinePoolFromEnv();
+  uint64_t memoryBudget = memoryBudgetFromEnv();
+  // A set that is being computed is finished first, so a request arriving meanwhile waits for at most one set
+  while (offlineCount(keys) < pool && !ready()) {
+    storeOffline(keys, precompute(keys, memoryBudget));
+  }
+}
+
+vector<ProofCodec::Proof> Prover::proveBatch(const ProverKeys& keys, const vector<vector<uint64_t>>& witnesses, uint64_t memoryBudget, size_t batchSize) {
+  if (batchSize == 0) {
+    batchSize = TaskGraph::defaultThreads();
+  }
+  vector<ProofJob> jobs;
+  for (const vector<uint64_t>& witness : witnesses) {
+    jobs.push_back({ witness.data(), witness.size(), nullptr, false, false });
+  }
+  vector<ProofCodec::Proof> proofs(witnesses.size());
+  for (size_t first = 0; first < witnesses.size(); first += batchSize) {
+    TaskGraph graph;
+    graph.setMemoryBudget(memoryBudget);
+    proveFrom(graph, keys, jobs, first, min(first + batchSize, witnesses.size()), memoryBudget, proofs);
+  }
+  return proofs;
+}
+
+std::string Prover::proofFormatFromEnv() {
+  // FIDESINNOVA_PROOF_FORMAT selects data/proof.json (default), data/proof.bin ("binary") or a zstd-compressed
+  // data/proof.bin ("zstd"), checked before proving so a typo does not cost a proof
+  std::string proofFormat = getenv("FIDESINNOVA_PROOF_FORMAT") != nullptr ? getenv("FIDESINNOVA_PROOF_FORMAT") : "json";
+  if (proofFormat != "json" && proofFormat != "binary" && proofFormat != "zstd") {
+    throw std::runtime_error("Error: Fides FIDESINNOVA_PROOF_FORMAT must be json, binary or zstd");
+  }
+#ifndef FIDES_PROOF_ZSTD
+  if (proofFormat == "zstd") {
+    throw std::runtime_error("Error: Fides FIDESINNOVA_PROOF_FORMAT=zstd requires a build with -DFIDES_PROOF_ZSTD -lzstd");
+  }
+#endif
+  return proofFormat;
+}
+
+bool Prover::succinctFromEnv() {
+  // FIDESINNOVA_PROOF_MODE selects full proofs (default) or succinct ones, checked before proving like the format
+  std::string proofMode = getenv("FIDESINNOVA_PROOF_MODE") != nullptr ? getenv("FIDESINNOVA_PROOF_MODE") : "full";
+  if (proofMode != "full" && proofMode != "succinct") {
+    throw std::runtime_error("Error: Fides FIDESINNOVA_PROOF_MODE must be full or succinct");
+  }
+  return proofMode == "succinct";
+}
+
+bool Prover::writeProof(const ProofCodec::Proof& proof, const std::string& proofFormat, uint64_t timeTakenMs, uint64_t memoryBudget) {
+  ProverMetrics::Scope serializationScope("serialization");
+  FIDES_LOG_DEBUG(cout << "\n\n\n\n" << ProofCodec::toJson(proof) << "\n\n\n\n");
+
+  // Print the time taken
+  FIDES_LOG_INFO(cout << "Time taken: " << timeTakenMs << " milliseconds" << endl);
+
+  // Print the peak working set, so the largest class that fits a device can be read off a smaller run
+  FIDES_LOG_INFO(
+    cout << "Peak working set: " << peakWorkingSet() << " bytes";
+    if (memoryBudget != 0) {
+      cout << " (memory budget: " << memoryBudget << " bytes)";
+    }
+    cout << endl
+  );
+
+  // The file of the other format is removed so the verifier never reads a stale proof
+  std::string proofPath = proofFormat == "json" ? "data/proof.json" : "data/proof.bin";
+  bool proofWritten;
+  if (proofFormat == "json") {
+    std::string proofString = ProofCodec::toJson(proof).dump(4);
+    std::ofstream proofFile(proofPath);
+    proofWritten = proofFile.is_open();
+    if (proofWritten) {
+        proofFile << proofString;
+        proofFile.close();
+    }
+    remove("data/proof.bin");
+  } else {
+    proofWritten = ProofCodec::writeFile(proofPath, ProofCodec::encode(proof, proofFormat == "zstd"));
+    remove("data/proof.json");
+  }
+  serializationScope.stop();
+
+  // Write the per-phase timers and counters next to the proof and print them as a table
+  ordered_json metrics;
+  metrics["commitmentId"] = proof.commitmentId;
+  metrics["class"] = proof.Class;
+  metrics["threads"] = TaskGraph::defaultThreads();
+  metrics["time_taken_ms"] = timeTakenMs;
+  metrics["peak_working_set_bytes"] = peakWorkingSet();
+  metrics["phases"] = ordered_json::array();
+  for (auto& entry : ProverMetrics::allPhases()) {
+    ordered_json phaseJson;
+    phaseJson["name"] = entry->name;
+    phaseJson["calls"] = entry->calls.load();
+    phaseJson["busy_ms"] = entry->nanoseconds / 1e6;
+    phaseJson["wall_ms"] = entry->lastEnd > entry->firstStart ? (entry->lastEnd - entry->firstStart) / 1e6 : 0;
+    phaseJson["field_multiplies"] = entry->fieldMultiplies.load();
+    phaseJson["inversions"] = entry->inversions.load();
+    phaseJson["bytes_allocated"] = entry->bytesAllocated.load();
+    phaseJson["polynomial_multiplies"] = ordered_json::object();
+    for (auto& bucket : entry->polynomialMultiplies) {
+      phaseJson["polynomial_multiplies"][to_string(bucket.first)] = bucket.second;
+    }
+    metrics["phases"].push_back(phaseJson);
+  }
+  std::ofstream metricsFile("data/proof_metrics.json");
+  if (metricsFile.is_open()) {
+    metricsFile << metrics.dump(4);
+    metricsFile.close();
+  }
+  FIDES_LOG_INFO(ProverMetrics::printTable(cout));
+
+  if (proofWritten) {
+    FIDES_LOG_INFO(std::cout << "Proof data has been written at " << proofPath << "\n");
+  }
+  return proofWritten;
+}
+
+void Prover::consume(const ProverKeys& keys, WitnessRing& ring, const atomic<bool>& stop) {
+  if (ring.slotSize() != 1 + keys.n_i + keys.n_g) {
+    throw std::runtime_error("Error: Fides witness ring holds " + to_string(ring.slotSize()) + " values, the commitment needs " + to_string(1 + keys.n_i + keys.n_g));
+  }
+  if (!ring.commitmentId().empty() && ring.commitmentId() != keys.commitmentID) {
+    throw std::runtime_error("Error: Fides witness ring belongs to commitment " + ring.commitmentId() + ", not " + keys.commitmentID);
+  }
+  std::string proofFormat = proofFormatFromEnv();
+  uint64_t memoryBudget = memoryBudgetFromEnv();
+  bool checkpoint = checkpointFromEnv();
+  bool succinct = succinctFromEnv();
+  // Every proof replaces data/proof.json (or .bin); FIDESINNOVA_PROOF_PUBLISH also keeps each one in that
+  // directory under a name of its own, as serve does
+  const char* publishDirectory = getenv("FIDESINNOVA_PROOF_PUBLISH");
+  uint64_t dropped = 0;
+  vector<uint64_t> witness;
+  while (true) {
+    if (!ring.pop(witness)) {
+      if (stop.load()) {
+        return;
+      }
+      // Idle time goes to offline sets; the producer never signals, so an empty ring is polled and a proof
+      // takes far longer than the interval
+      refillOffline(keys, [&] { return stop.load() || ring.pending() != 0; });
+      usleep(1000);
+      continue;
+    }
+    if (ring.dropped() != dropped) {
+      dropped = ring.dropped();
+      FIDES_LOG_ERROR(cerr << "Warning: Fides witness ring was full, " << dropped << " snapshots dropped so far" << endl);
+    }
+    // A snapshot that fails to prove is skipped, so one bad witness does not stop the prover thread
+    try {
+      checkWitness(keys, witness.data(), witness.size());
+      ProverOffline offline;
+      takeOffline(keys, offline);
+      ProverMetrics::reset();
+      auto start_time = chrono::high_resolution_clock::now();
+      ProofCodec::Proof proof = prove(keys, witness, memoryBudget, &offline, checkpoint, succinct);
+      auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start_time);
+      if (!writeProof(proof, proofFormat, duration.count(), memoryBudget)) {
+        FIDES_LOG_ERROR(cerr << "Error: Fides cannot write the proof to data" << endl);
+      }
+      if (publishDirectory != nullptr) {
+        std::string path = std::string(publishDirectory) + "/proof_" + keys.commitmentID.substr(0, 16) + "_" + uniqueFileTag() + ".bin";
+        if (!ProofCodec::writeFile(path, ProofCodec::encode(proof, proofFormat == "zstd"))) {
+          FIDES_LOG_ERROR(cerr << "Error: Fides prover cannot publish " << path << endl);
+        }
+      }
+    } catch (const std::exception& error) {
+      FIDES_LOG_ERROR(cerr << error.what() << "; snapshot skipped" << endl);
+    }
+  }
+}
+
+uint64_t Prover::memoryBudgetFromEnv() {
+  if (getenv("FIDESINNOVA_MEMORY_BUDGET") == nullptr) {
+    return 0;
+  }
+  return strtoull(getenv("FIDESINNOVA_MEMORY_BUDGET"), nullptr, 10);
+}
+
+bool Prover::checkpointFromEnv() {
+  const char* checkpoint = getenv("FIDESINNOVA_CHECKPOINT");
+  return checkpoint != nullptr && strcmp(checkpoint, "0") != 0;
+}
+
+uint64_t Prover::peakWorkingSet() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+// Largest witness message a server accepts, far above the largest class
+static const uint64_t MAX_WITNESS_MESSAGE = 1ull << 30;
+
+void Prover::serve(const vector<ProverKeys>& commitments, const std::string& address) {
+  int server = FidesSocket::open(address, true);
+  for (const ProverKeys& keys : commitments) {
+    FIDES_LOG_INFO(cout << "Prover for commitment " << keys.commitmentID << " (class " << keys.Class << ") listening on " << address << endl);
+  }
+  // FIDESINNOVA_PROOF_PUBLISH also writes every proof to that directory, for backends that collect them there
+  const char* publishDirectory = getenv("FIDESINNOVA_PROOF_PUBLISH");
+
+  uint64_t memoryBudget = memoryBudgetFromEnv();
+  bool succinct = succinctFromEnv();
+  auto connectionWaiting = [server] {
+    pollfd pending = { server, POLLIN, 0 };
+    return poll(&pending, 1, 0) > 0;
+  };
+  while (true) {
+    // Idle time goes to offline sets, so the next requests only run the witness-dependent phases
+    for (const ProverKeys& keys : commitments) {
+      refillOffline(keys, connectionWaiting);
+    }
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    // Requests are proved one at a time; each one already uses every worker of the task graph
+    uint64_t size = 0;
+    vector<uint8_t> request;
+    if (FidesSocket::readFully(client, &size, sizeof(size)) && size <= MAX_WITNESS_MESSAGE) {
+      request.resize(size);
+    }
+    if (size == request.size() && FidesSocket::readFully(client, request.data(), size)) {
+      uint8_t status = 0;
+      vector<uint8_t> reply;
+      try {
+        ProofCodec::Witness witness = ProofCodec::decodeWitness(request);
+        const ProverKeys* keys = nullptr;
+        for (const ProverKeys& candidate : commitments) {
+          if (candidate.commitmentID == witness.commitmentId) {
+            keys = &candidate;
+          }
+        }
+        if (keys == nullptr) {
+          throw std::runtime_error("Error: Fides prover has no keys for commitment " + witness.commitmentId);
+        }
+        checkWitness(*keys, witness.values.data(), witness.values.size());
+        ProverOffline offline;
+        takeOffline(*keys, offline);
+        auto start_time = chrono::high_resolution_clock::now();
+        ProverMetrics::reset();
+        reply = ProofCodec::encode(prove(*keys, witness.values, memoryBudget, &offline, false, succinct));
+        auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start_time);
+        FIDES_LOG_INFO(cout << "Proof for commitment " << keys->commitmentID << " generated in " << duration.count() << " milliseconds" << endl);
+        if (publishDirectory != nullptr) {
+          std::string path = std::string(publishDirectory) + "/proof_" + keys->commitmentID.substr(0, 16) + "_" + uniqueFileTag() + ".bin";
+          if (!ProofCodec::writeFile(path, reply)) {
+            FIDES_LOG_ERROR(cerr << "Error: Fides prover cannot publish " << path << endl);
+          }
+        }
+      } catch (const std::exception& error) {
+        status = 1;
+        std::string message = error.what();
+        reply.assign(message.begin(), message.end());
+        FIDES_LOG_ERROR(cerr << message << endl);
+      }
+      uint64_t replySize = reply.size();
+      FidesSocket::writeFully(client, &status, sizeof(status)) && FidesSocket::writeFully(client, &replySize, sizeof(replySize)) && FidesSocket::writeFully(client, reply.data(), replySize);
+    }
+    close(client);
+  }
+}
+
+vector<uint8_t> Prover::requestProof(const std::string& address, const vector<uint8_t>& witness) {
+  int client = FidesSocket::open(address, false);
+  uint64_t size = witness.size();
+  uint8_t status = 1;
+  vector<uint8_t> reply;
+  bool ok = FidesSocket::writeFully(client, &size, sizeof(size)) && FidesSocket::writeFully(client, witness.data(), size)
+    && FidesSocket::readFully(client, &status, sizeof(status)) && FidesSocket::readFully(client, &size, sizeof(size));
+  if (ok) {
+    reply.resize(size);
+    ok = FidesSocket::readFully(client, reply.data(), size);
+  }
+  close(client);
+  if (!ok) {
+    throw std::runtime_error("Error: Fides prover at " + address + " closed the connection");
+  }
+  if (status != 0) {
+    throw std::runtime_error(std::string(reply.begin(), reply.end()));
+  }
+  return reply;
+}
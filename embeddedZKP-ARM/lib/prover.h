@@ -0,0 +1,172 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PROVER_H
+#define PROVER_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include "proofCodec.h"
+#include "witnessRing.h"
+#include "commitmentBackend.h"
+
+using namespace std;
+
+// Everything a proof needs that does not depend on the witness: the commitment, param, class and setup files
+// and the domains derived from them. Loaded once per commitment and only read while proving.
+struct ProverKeys {
+  // Directory the files were loaded from; spilled polynomials go to its data/ subdirectory
+  std::string directory = ".";
+
+  uint64_t Class = 0;
+  std::string commitmentID;
+
+  // Commitment polynomials row/col/val_AHP_M(x) and their commitments Com_AHP0 .. Com_AHP8
+  vector<uint64_t> rowA_x, colA_x, valA_x, rowB_x, colB_x, valB_x, rowC_x, colC_x, valC_x;
+  vector<uint64_t> Com_AHP;
+
+  // Nonzero entries of A, B and C and their K-domain mappings from program_param.json
+  vector<uint64_t> nonZeroA, nonZeroC;
+  vector<vector<uint64_t>> nonZeroB;
+  vector<uint64_t> rowA, colA, valA, rowB, colB, valB, rowC, colC, valC;
+  // Assembly line of the first gate (gate i is on line line + i), 0 if program_param.json predates it
+  uint64_t line = 0;
+
+  // Class parameters and the KZG setup
+  uint64_t n_i = 0, n_g = 0, n = 0, m = 0, p = 0, g = 0;
+  vector<uint64_t> ck;
+  uint64_t vk = 0;
+  // Commitment scheme over the setup, chosen with FIDESINNOVA_COMMITMENT_BACKEND
+  shared_ptr<const CommitmentBackend> commitment;
+
+  // H of order n with generator w, K of order m, their vanishing polynomials, the index of every point of H
+  // and r(h, h) for every h in H
+  vector<uint64_t> H, K, vH_x, vK_x, r_h_h;
+  uint64_t w = 0;
+  unordered_map<uint64_t, uint64_t> H_index;
+
+  // v_H(x) vanishing on the first t = n_i + 1 points of H, and vH(x) / v_H(x) vanishing on the other points
+  vector<uint64_t> v_H, vH_div_v_H;
+};
+
+// Witness-independent material of one proof: the zero-knowledge masks, the challenges derived from s(x) and
+// everything computed from them alone (A/B/C_hat weighted by eta, the second and third sumchecks, their
+// commitments and the index terms of p(x)). Precomputed while the device is idle and used for exactly one proof.
+struct ProverOffline {
+  bool ready = false;
+  std::string commitmentID;
+  uint64_t b = 0;
+  // Coefficients of the zero-knowledge masks of z_hatA/B/C and w_hat, b of each
+  vector<uint64_t> maskA, maskB, maskC, mask_w;
+  vector<uint64_t> s_x;
+  uint64_t sigma1 = 0;
+  uint64_t alpha = 0, etaA = 0, etaB = 0, etaC = 0, beta1 = 0, beta2 = 0, x_prime = 0;
+  vector<uint64_t> eta_p;
+  vector<uint64_t> Sum_M_eta_M_r_M_alpha_x;
+  uint64_t sigma2 = 0, sigma3 = 0;
+  vector<uint64_t> g_2_x, h_2_x, g_3_x, h_3_x;
+  vector<uint64_t> p_x_offline;
+  // Com7_AHP_x (s) and Com10..13_AHP_x (g2, h2, g3, h3) at their indices, the rest 0
+  vector<uint64_t> Com_AHP_x;
+};
+
+// Reentrant prover: every call only reads its keys and keeps its state on its own stack, so any number of threads
+// can prove against the same keys at once. Nothing exits the process; errors are thrown as std::runtime_error.
+// ProofCodec::encode turns a proof into bytes. Install a ProverMetrics::Registry with ProverMetrics::Use on the
+// calling thread to keep the metrics of concurrent proofs apart.
+class Prover {
+public:
+  // Function to load program_commitment.json, program_param.json, class.json and data/setupN.json from directory
+  // and derive the state every proof shares. A missing file is read from stdin if promptIfMissing is set and
+  // throws otherwise
+  static ProverKeys loadKeys(const std::string& directory = ".", bool promptIfMissing = true);
+
+  // Function to prove one execution of the committed program; witness holds the count >= 1 + n_i + n_g values of
+  // z_array. A nonzero memoryBudget bounds the concurrently running tasks and spills proof polynomials to data/
+  // With a ready offline set only the witness-dependent phases run, and the set is used up.
+  // With checkpoint set the proof saves its progress to data/checkpoint_* and resumes from what an interrupted
+  // proof of the same commitment saved there; the files are removed once the proof is complete.
+  // A succinct proof carries commitments, evaluations and openings instead of the polynomials, so its size and
+  // verification time hardly depend on the class; it reuses the same offline sets and checkpoints
+  static ProofCodec::Proof prove(const ProverKeys& keys, const uint64_t* witness, size_t count, uint64_t memoryBudget = 0, ProverOffline* offline = nullptr, bool checkpoint = false, bool succinct = false);
+  static ProofCodec::Proof prove(const ProverKeys& keys, const vector<uint64_t>& witness, uint64_t memoryBudget = 0, ProverOffline* offline = nullptr, bool checkpoint = false, bool succinct = false);
+
+  // Function to check in O(n_g + nonzero entries) that the witness satisfies every gate, (Az)(Bz) = Cz on the
+  // gate rows; throws naming the first failing gate and its assembly line, where a proof would only be rejected
+  static void checkWitness(const ProverKeys& keys, const uint64_t* witness, size_t count);
+
+  // Function to compute the witness-independent material of one future proof
+  static ProverOffline precompute(const ProverKeys& keys, uint64_t memoryBudget = 0);
+
+  // Function to store an offline set in the data/ directory of the keys
+  static void storeOffline(const ProverKeys& keys, const ProverOffline& offline);
+
+  // Function to take one stored offline set of the commitment, removing it from disk; false if none is left
+  static bool takeOffline(const ProverKeys& keys, ProverOffline& offline);
+
+  // Function to count the stored offline sets of the commitment
+  static size_t offlineCount(const ProverKeys& keys);
+
+  // Function to read FIDESINNOVA_OFFLINE_POOL, the number of offline sets to keep stored while idle (0 when unset)
+  static size_t offlinePoolFromEnv();
+
+  // Function to precompute and store offline sets until offlinePoolFromEnv() are stored or ready() returns true
+  static void refillOffline(const ProverKeys& keys, const function<bool()>& ready);
+
+  // Function to prove several executions of the committed program. The task graphs of up to batchSize proofs
+  // share one worker pool (0 picks one proof per worker), so the per-witness phases of a batch run side by side
+  static vector<ProofCodec::Proof> proveBatch(const ProverKeys& keys, const vector<vector<uint64_t>>& witnesses, uint64_t memoryBudget = 0, size_t batchSize = 0);
+
+  // Function to read FIDESINNOVA_PROOF_FORMAT: json (default), binary or zstd
+  static std::string proofFormatFromEnv();
+
+  // Function to read FIDESINNOVA_PROOF_MODE: full (default) or succinct
+  static bool succinctFromEnv();
+
+  // Function to print the time and peak working set of a proof, write it to data/proof.json or data/proof.bin
+  // and its metrics to data/proof_metrics.json; returns false if the proof file cannot be written
+  static bool writeProof(const ProofCodec::Proof& proof, const std::string& format, uint64_t timeTakenMs, uint64_t memoryBudget);
+
+  // Function to prove and write every witness pushed to ring until stop is set and the ring is empty. Each proof
+  // replaces the previous one in data, and is also kept under a unique name in FIDESINNOVA_PROOF_PUBLISH if set;
+  // a witness that fails to prove is logged and skipped
+  static void consume(const ProverKeys& keys, WitnessRing& ring, const atomic<bool>& stop);
+
+  // Function to read FIDESINNOVA_CHECKPOINT, whether proofs save progress to resume after an interruption
+  static bool checkpointFromEnv();
+
+  // Function to read FIDESINNOVA_MEMORY_BUDGET (0 when unset)
+  static uint64_t memoryBudgetFromEnv();
+
+  // Function to get the peak resident set size of the process in bytes
+  static uint64_t peakWorkingSet();
+
+  // Function to serve proofs for the commitments on address, "tcp:host:port" or a Unix domain socket path, until
+  // the process is stopped. A request is a uint64_t length and a witness encoded by ProofCodec::encodeWitness; the
+  // reply is a status byte (0 for a proof, 1 for an error), a uint64_t length and that many bytes of binary proof
+  // or error message
+  static void serve(const vector<ProverKeys>& commitments, const std::string& address);
+
+  // Function to send an encoded witness to a prover started with serve and return the binary proof; the witness
+  // carries its commitment id, so the caller needs none of the key files
+  static vector<uint8_t> requestProof(const std::string& address, const vector<uint8_t>& witness);
+};
+
+#endif  // PROVER_H
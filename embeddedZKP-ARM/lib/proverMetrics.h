@@ -0,0 +1,229 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PROVERMETRICS_H
+#define PROVERMETRICS_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+// Per-phase timers and operation counters for the prover.
+// A Scope attributes the wall time of a block and the Polynomial operations run by the same thread to a
+// named phase. Phases may be entered by several tasks at once, so every counter is atomic.
+// Phases live in a Registry; a thread counts into the registry it installed with Use, or into a process-wide
+// one, so proofs running concurrently in one process keep separate metrics.
+// Header only, so commitmentGenerator and verifier link Polynomial without extra sources; outside a Scope
+// the counters are a thread-local null check.
+class ProverMetrics {
+public:
+  struct Phase {
+    std::string name;
+    atomic<uint64_t> calls{0};
+    atomic<uint64_t> nanoseconds{0};
+    atomic<uint64_t> firstStart{UINT64_MAX};
+    atomic<uint64_t> lastEnd{0};
+    atomic<uint64_t> fieldMultiplies{0};
+    atomic<uint64_t> inversions{0};
+    atomic<uint64_t> bytesAllocated{0};
+    mutex lock;
+    // Number of polynomial multiplications keyed by the power of two bounding the larger operand
+    map<uint64_t, uint64_t> polynomialMultiplies;
+  };
+
+  // The phases of one proof, in the order they were first entered
+  class Registry {
+  public:
+    // Function to get (or create) the phase with the given name
+    Phase& phase(const std::string& name) {
+      lock_guard<mutex> guard(lock);
+      for (auto& entry : phases) {
+        if (entry->name == name) {
+          return *entry;
+        }
+      }
+      phases.push_back(unique_ptr<Phase>(new Phase()));
+      phases.back()->name = name;
+      return *phases.back();
+    }
+
+    const vector<unique_ptr<Phase>>& allPhases() const {
+      return phases;
+    }
+
+    void clear() {
+      lock_guard<mutex> guard(lock);
+      phases.clear();
+    }
+
+  private:
+    mutex lock;
+    vector<unique_ptr<Phase>> phases;
+  };
+
+  // Scoped installation of a registry for the current thread
+  class Use {
+  public:
+    explicit Use(Registry& registry) : previous(installed()) {
+      installed() = &registry;
+    }
+    ~Use() {
+      installed() = previous;
+    }
+
+  private:
+    Registry* previous;
+  };
+
+  // Scoped timer that attributes the current thread's work to a phase until it is stopped or destroyed
+  class Scope {
+  public:
+    explicit Scope(const std::string& name) : Scope(ProverMetrics::registry(), name) {
+    }
+    Scope(Registry& registry, const std::string& name) : phase(&registry.phase(name)), previous(current()), start(now()) {
+      current() = phase;
+    }
+    ~Scope() {
+      stop();
+    }
+    void stop() {
+      if (phase == nullptr) {
+        return;
+      }
+      uint64_t end = now();
+      phase->calls++;
+      phase->nanoseconds += end - start;
+      atomicMin(phase->firstStart, start);
+      atomicMax(phase->lastEnd, end);
+      current() = previous;
+      phase = nullptr;
+    }
+
+  private:
+    Phase* phase;
+    Phase* previous;
+    uint64_t start;
+  };
+
+  // Function to get the registry of the current thread
+  static Registry& registry() {
+    static Registry process;
+    return installed() != nullptr ? *installed() : process;
+  }
+
+  // Function to get (or create) the phase with the given name
+  static Phase& phase(const std::string& name) {
+    return registry().phase(name);
+  }
+
+  // Function to get every phase, in the order they were first entered
+  static const vector<unique_ptr<Phase>>& allPhases() {
+    return registry().allPhases();
+  }
+
+  // Function to count field multiplications in the current phase
+  static void countFieldMultiplies(uint64_t count) {
+    if (Phase* p = current()) {
+      p->fieldMultiplies.fetch_add(count, memory_order_relaxed);
+    }
+  }
+
+  // Function to count field inversions in the current phase
+  static void countInversions(uint64_t count) {
+    if (Phase* p = current()) {
+      p->inversions.fetch_add(count, memory_order_relaxed);
+    }
+  }
+
+  // Function to count the bytes of newly allocated polynomial storage in the current phase
+  static void countBytesAllocated(uint64_t bytes) {
+    if (Phase* p = current()) {
+      p->bytesAllocated.fetch_add(bytes, memory_order_relaxed);
+    }
+  }
+
+  // Function to count a schoolbook multiplication of polynomials with size1 and size2 coefficients
+  static void countPolynomialMultiply(uint64_t size1, uint64_t size2) {
+    if (Phase* p = current()) {
+      p->fieldMultiplies.fetch_add(size1 * size2, memory_order_relaxed);
+      uint64_t bucket = 1;
+      while (bucket < max(size1, size2)) {
+        bucket <<= 1;
+      }
+      lock_guard<mutex> guard(p->lock);
+      p->polynomialMultiplies[bucket]++;
+    }
+  }
+
+  // Function to print every phase as a table
+  static void printTable(ostream& out) {
+    out << left << setw(18) << "phase" << right << setw(7) << "calls" << setw(11) << "busy ms" << setw(11) << "wall ms"
+        << setw(16) << "field mults" << setw(12) << "inversions" << setw(14) << "KiB alloc" << "  poly mults (size<=n: count)" << endl;
+    for (auto& entry : allPhases()) {
+      Phase& p = *entry;
+      uint64_t wall = p.lastEnd > p.firstStart ? p.lastEnd - p.firstStart : 0;
+      out << left << setw(18) << p.name << right << setw(7) << p.calls << setw(11) << fixed << setprecision(2) << p.nanoseconds / 1e6
+          << setw(11) << wall / 1e6 << setw(16) << p.fieldMultiplies << setw(12) << p.inversions << setw(14) << p.bytesAllocated / 1024 << " ";
+      lock_guard<mutex> guard(p.lock);
+      for (auto& bucket : p.polynomialMultiplies) {
+        out << " " << bucket.first << ": " << bucket.second;
+      }
+      out << endl;
+    }
+  }
+
+  // Function to clear every phase before a new proof
+  static void reset() {
+    registry().clear();
+  }
+
+private:
+  static Registry*& installed() {
+    thread_local Registry* registry = nullptr;
+    return registry;
+  }
+
+  static Phase*& current() {
+    thread_local Phase* phase = nullptr;
+    return phase;
+  }
+
+  static uint64_t now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static void atomicMin(atomic<uint64_t>& target, uint64_t value) {
+    uint64_t seen = target;
+    while (value < seen && !target.compare_exchange_weak(seen, value)) {
+    }
+  }
+
+  static void atomicMax(atomic<uint64_t>& target, uint64_t value) {
+    uint64_t seen = target;
+    while (value > seen && !target.compare_exchange_weak(seen, value)) {
+    }
+  }
+};
+
+#endif  // PROVERMETRICS_H
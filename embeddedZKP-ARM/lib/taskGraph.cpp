@@ -0,0 +1,195 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "taskGraph.h"
+#include <thread>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+// Function to add a task that starts once every task in deps has finished
+TaskGraph::TaskId TaskGraph::addTask(const std::string& name, function<void()> fn, const vector<TaskId>& deps, uint64_t bytes) {
+  TaskId id = tasks.size();
+  unique_ptr<Task> task(new Task());
+  task->name = name;
+  task->fn = fn;
+  task->bytes = bytes;
+  for (TaskId dep : deps) {
+    if (dep >= id) {
+      throw std::runtime_error("Error: TaskGraph task " + name + " depends on a task that is not added yet");
+    }
+    tasks[dep]->successors.push_back(id);
+    task->numDeps++;
+  }
+  tasks.push_back(std::move(task));
+  return id;
+}
+
+// Function to limit the summed byte estimates of concurrently running tasks (0 disables the limit)
+void TaskGraph::setMemoryBudget(uint64_t bytes) {
+  memoryBudget = bytes;
+}
+
+// Function to get the number of workers used when numThreads is 0 (FIDESINNOVA_THREADS overrides it)
+unsigned TaskGraph::defaultThreads() {
+  const char* env = getenv("FIDESINNOVA_THREADS");
+  if (env != nullptr && atoi(env) > 0) {
+    return atoi(env);
+  }
+  unsigned cores = thread::hardware_concurrency();
+  return cores == 0 ? 1 : cores;
+}
+
+// Function to queue a ready task on a worker and wake an idle one
+void TaskGraph::push(size_t worker, TaskId id) {
+  {
+    lock_guard<mutex> guard(queues[worker]->lock);
+    queues[worker]->tasks.push_back(id);
+  }
+  ready++;
+  {
+    lock_guard<mutex> guard(sleepLock);
+  }
+  wake.notify_one();
+}
+
+// Function to take a task from the back of the own queue or the front of another queue
+bool TaskGraph::pop(size_t self, TaskId& id) {
+  {
+    lock_guard<mutex> guard(queues[self]->lock);
+    if (!queues[self]->tasks.empty()) {
+      id = queues[self]->tasks.back();
+      queues[self]->tasks.pop_back();
+      ready--;
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues.size(); i++) {
+    WorkerQueue& victim = *queues[(self + i) % queues.size()];
+    lock_guard<mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      id = victim.tasks.front();
+      victim.tasks.pop_front();
+      ready--;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function to execute tasks until the graph is done, stealing from other workers when idle
+void TaskGraph::workerLoop(size_t self) {
+  while (completed < tasks.size() && !failed) {
+    TaskId id;
+    if (!pop(self, id)) {
+      unique_lock<mutex> guard(sleepLock);
+      wake.wait(guard, [&] { return ready > 0 || completed == tasks.size() || failed; });
+      continue;
+    }
+
+    // Under a memory budget, hold the task until the tasks already running leave room for it
+    uint64_t bytes = memoryBudget == 0 ? 0 : tasks[id]->bytes;
+    {
+      unique_lock<mutex> guard(sleepLock);
+      wake.wait(guard, [&] { return runningTasks == 0 || runningBytes + bytes <= memoryBudget || failed; });
+      if (failed) {
+        return;
+      }
+      runningBytes += bytes;
+      runningTasks++;
+    }
+
+    try {
+      tasks[id]->fn();
+    } catch (...) {
+      lock_guard<mutex> guard(sleepLock);
+      if (!failed) {
+        error = current_exception();
+        failed = true;
+      }
+      runningBytes -= bytes;
+      runningTasks--;
+      wake.notify_all();
+      return;
+    }
+
+    {
+      lock_guard<mutex> guard(sleepLock);
+      runningBytes -= bytes;
+      runningTasks--;
+    }
+    if (memoryBudget != 0) {
+      wake.notify_all();
+    }
+
+    // Successors that became ready stay on this worker, where their inputs are still in cache
+    for (TaskId next : tasks[id]->successors) {
+      if (--tasks[next]->remaining == 0) {
+        push(self, next);
+      }
+    }
+    if (++completed == tasks.size()) {
+      lock_guard<mutex> guard(sleepLock);
+      wake.notify_all();
+    }
+  }
+}
+
+// Function to run every task, using numThreads workers (0 picks the hardware concurrency)
+void TaskGraph::run(unsigned numThreads) {
+  if (numThreads == 0) {
+    numThreads = defaultThreads();
+  }
+  if (numThreads > tasks.size()) {
+    numThreads = tasks.size() == 0 ? 1 : tasks.size();
+  }
+
+  queues.clear();
+  for (unsigned i = 0; i < numThreads; i++) {
+    queues.push_back(unique_ptr<WorkerQueue>(new WorkerQueue()));
+  }
+  ready = 0;
+  completed = 0;
+  failed = false;
+  error = nullptr;
+  runningBytes = 0;
+  runningTasks = 0;
+
+  // Spread the initially ready tasks over the workers
+  size_t next = 0;
+  for (TaskId id = 0; id < tasks.size(); id++) {
+    tasks[id]->remaining = tasks[id]->numDeps;
+    if (tasks[id]->numDeps == 0) {
+      queues[next % numThreads]->tasks.push_back(id);
+      ready++;
+      next++;
+    }
+  }
+
+  // The calling thread is worker 0
+  vector<thread> workers;
+  for (unsigned i = 1; i < numThreads; i++) {
+    workers.emplace_back(&TaskGraph::workerLoop, this, i);
+  }
+  workerLoop(0);
+  for (thread& worker : workers) {
+    worker.join();
+  }
+
+  if (error) {
+    rethrow_exception(error);
+  }
+}
@@ -0,0 +1,90 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+
+using namespace std;
+
+// A dependency graph of tasks executed on a small work-stealing pool.
+// Tasks can only depend on tasks added before them, so the graph is acyclic by construction.
+class TaskGraph {
+public:
+  typedef size_t TaskId;
+
+  // Function to add a task that starts once every task in deps has finished
+  // bytes is an estimate of the memory the task allocates while it runs (0 when negligible)
+  TaskId addTask(const std::string& name, function<void()> fn, const vector<TaskId>& deps = {}, uint64_t bytes = 0);
+
+  // Function to limit the summed byte estimates of concurrently running tasks (0 disables the limit)
+  // A task larger than the budget still runs, but only once nothing else is running
+  void setMemoryBudget(uint64_t bytes);
+
+  // Function to run every task, using numThreads workers (0 picks the hardware concurrency)
+  // The first exception thrown by a task is rethrown here once all workers have stopped
+  void run(unsigned numThreads = 0);
+
+  // Function to get the number of workers used when numThreads is 0 (FIDESINNOVA_THREADS overrides it)
+  static unsigned defaultThreads();
+
+private:
+  struct Task {
+    std::string name;
+    function<void()> fn;
+    vector<TaskId> successors;
+    size_t numDeps = 0;
+    uint64_t bytes = 0;
+    atomic<size_t> remaining{0};
+  };
+
+  struct WorkerQueue {
+    mutex lock;
+    deque<TaskId> tasks;
+  };
+
+  // Function to execute tasks until the graph is done, stealing from other workers when idle
+  void workerLoop(size_t self);
+
+  // Function to queue a ready task on a worker and wake an idle one
+  void push(size_t worker, TaskId id);
+
+  // Function to take a task from the back of the own queue or the front of another queue
+  bool pop(size_t self, TaskId& id);
+
+  vector<unique_ptr<Task>> tasks;
+  vector<unique_ptr<WorkerQueue>> queues;
+  atomic<size_t> ready{0};
+  atomic<size_t> completed{0};
+  atomic<bool> failed{false};
+  exception_ptr error;
+  uint64_t memoryBudget = 0;
+  uint64_t runningBytes = 0;
+  size_t runningTasks = 0;
+  mutex sleepLock;
+  condition_variable wake;
+};
+
+#endif  // TASKGRAPH_H
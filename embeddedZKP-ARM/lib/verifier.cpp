@@ -0,0 +1,687 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verifier.h"
+#include "polynomial.h"
+#include "fidesLog.h"
+#include "fidesRandom.h"
+#include "fidesSocket.h"
+#include "jsonLoader.h"
+#include "json.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace std;
+using ordered_json = nlohmann::ordered_json;
+
+// Largest proof message a verifier daemon accepts, far above the proof of the largest class
+static const uint64_t MAX_PROOF_MESSAGE = 1ull << 28;
+
+// Function to open a JSON file of a project directory
+static void loadJsonFile(JsonLoader& loader, const std::string& directory, const std::string& name) {
+  std::string path = directory + "/" + name;
+  FIDES_LOG_DEBUG(cout << "openning " << path << endl);
+  if (!loader.loadFile(path)) {
+    FIDES_LOG_ERROR(std::cerr << "Could not open the file!" << std::endl);
+    throw std::runtime_error("Error: Fides verifier cannot read " + path);
+  }
+}
+
+VerifierKeys Verifier::loadKeys(const std::string& directory) {
+  VerifierKeys keys;
+  keys.directory = directory;
+
+  /*******************************  Read Commitment  ******************************/
+  JsonLoader commitmentJsonData;
+  loadJsonFile(commitmentJsonData, directory, "program_commitment.json");
+  keys.commitmentID = commitmentJsonData.text("/commitmentId");
+  keys.Class = commitmentJsonData.number("/class");
+
+  keys.rowA_x = commitmentJsonData.take("/row_AHP_A");
+  keys.colA_x = commitmentJsonData.take("/col_AHP_A");
+  keys.valA_x = commitmentJsonData.take("/val_AHP_A");
+  keys.rowB_x = commitmentJsonData.take("/row_AHP_B");
+  keys.colB_x = commitmentJsonData.take("/col_AHP_B");
+  keys.valB_x = commitmentJsonData.take("/val_AHP_B");
+  keys.rowC_x = commitmentJsonData.take("/row_AHP_C");
+  keys.colC_x = commitmentJsonData.take("/col_AHP_C");
+  keys.valC_x = commitmentJsonData.take("/val_AHP_C");
+
+  keys.Com0_AHP = commitmentJsonData.number("/Com_AHP0");
+  keys.Com1_AHP = commitmentJsonData.number("/Com_AHP1");
+  keys.Com2_AHP = commitmentJsonData.number("/Com_AHP2");
+  keys.Com3_AHP = commitmentJsonData.number("/Com_AHP3");
+  keys.Com4_AHP = commitmentJsonData.number("/Com_AHP4");
+  keys.Com5_AHP = commitmentJsonData.number("/Com_AHP5");
+  keys.Com6_AHP = commitmentJsonData.number("/Com_AHP6");
+  keys.Com7_AHP = commitmentJsonData.number("/Com_AHP7");
+  keys.Com8_AHP = commitmentJsonData.number("/Com_AHP8");
+  /*******************************  Read Commitment  ******************************/
+
+
+  /*********************************  Read Setup  *********************************/
+  JsonLoader setupJsonData;
+  loadJsonFile(setupJsonData, directory, "data/setup" + to_string(keys.Class) + ".json");
+  keys.ck = setupJsonData.take("/ck");
+  keys.vk = setupJsonData.number("/vk");
+  /*********************************  Read Setup  *********************************/
+
+
+  /*********************************  Read Class  *********************************/
+  JsonLoader classJsonData;
+  loadJsonFile(classJsonData, directory, "class.json");
+  string class_value = to_string(keys.Class); // Convert uinteger to string class
+  keys.n_g = classJsonData.number("/" + class_value + "/n_g");
+  keys.n_i = classJsonData.number("/" + class_value + "/n_i");
+  keys.n   = classJsonData.number("/" + class_value + "/n");
+  keys.m   = classJsonData.number("/" + class_value + "/m");
+  keys.p   = classJsonData.number("/" + class_value + "/p");
+  keys.g   = classJsonData.number("/" + class_value + "/g");
+  /*********************************  Read Class  *********************************/
+
+  keys.commitment = CommitmentBackend::createForProofs(CommitmentBackend::nameFromEnv(), keys.ck, keys.vk, keys.g, keys.p);
+
+  // The parts of the checks that only depend on the class: the first t = n_i + 1 points of H, the last point
+  // w^(n-1) where y is read off z_hatC, and the inverses of n and m
+  const uint64_t p = keys.p;
+  uint64_t w = Polynomial::power(keys.g, ((p - 1) / keys.n) % p, p);
+  keys.H_t.push_back(1);
+  for (uint64_t i = 1; i <= keys.n_i; i++) {
+    keys.H_t.push_back((keys.H_t[i - 1] * w) % p);
+  }
+  keys.H_last = Polynomial::power(w, keys.n - 1, p);
+  keys.inverse_n = Polynomial::pInverse(keys.n, p);
+  keys.inverse_m = Polynomial::pInverse(keys.m, p);
+
+  // The points a succinct proof opens s(x) at and the commitment of the polynomial vanishing on them
+  vector<uint64_t> Z_s = { 1 };
+  for (uint64_t k = 0; k < ProofCodec::SUCCINCT_S_POINTS; k++) {
+    keys.S_points.push_back(k);
+    Z_s = Polynomial::multiplyPolynomials(Z_s, { (p - k) % p, 1 }, p);
+  }
+  keys.Com_Z_s = keys.commitment->commitDivisor(Z_s);
+
+  FIDES_LOG_DEBUG(cout << "n: " << keys.n << endl);
+  FIDES_LOG_DEBUG(cout << "m: " << keys.m << endl);
+  FIDES_LOG_DEBUG(cout << "g: " << keys.g << endl);
+  return keys;
+}
+
+IndexEvaluations Verifier::evaluateIndex(const VerifierKeys& keys) {
+  const uint64_t p = keys.p;
+  IndexEvaluations index;
+  index.beta3 = Polynomial::generateRandomNumber({0}, 1000);
+  index.rowA = Polynomial::evaluatePolynomial(keys.rowA_x, index.beta3, p);
+  index.colA = Polynomial::evaluatePolynomial(keys.colA_x, index.beta3, p);
+  index.valA = Polynomial::evaluatePolynomial(keys.valA_x, index.beta3, p);
+  index.rowB = Polynomial::evaluatePolynomial(keys.rowB_x, index.beta3, p);
+  index.colB = Polynomial::evaluatePolynomial(keys.colB_x, index.beta3, p);
+  index.valB = Polynomial::evaluatePolynomial(keys.valB_x, index.beta3, p);
+  index.rowC = Polynomial::evaluatePolynomial(keys.rowC_x, index.beta3, p);
+  index.colC = Polynomial::evaluatePolynomial(keys.colC_x, index.beta3, p);
+  index.valC = Polynomial::evaluatePolynomial(keys.valC_x, index.beta3, p);
+  return index;
+}
+
+// The values the checks of a proof combine: its sums, the challenges, the public inputs and every polynomial at
+// the point its check reads it. A full proof yields them by evaluating its polynomials; a succinct proof carries
+// them and opens them against the commitments
+struct ProofValues {
+  uint64_t sigma1 = 0, sigma2 = 0, sigma3 = 0;
+  uint64_t alpha = 0, etaA = 0, etaB = 0, etaC = 0, beta1 = 0, beta2 = 0;
+  // eta_p[i] weights polynomial i of p(x): row, col and val of A, B and C, w_hat, z_hatA, z_hatB, z_hatC, h_0, s,
+  // g_1, h_1, g_2, h_2, g_3 and h_3
+  uint64_t eta_p[21] = {};
+  vector<uint64_t> publicInputs;
+  // w_hat, z_hatA, z_hatB, z_hatC, h_0, s, g_1 and h_1 at beta1, and g_2 and h_2 at beta2
+  uint64_t atBeta1[8] = {}, atBeta2[2] = {};
+  // The index polynomials, g_3 and h_3 at beta3
+  IndexEvaluations index;
+  uint64_t g_3 = 0, h_3 = 0;
+};
+
+// Function to derive the challenges from s(0) .. s(30), the values they are hashed from
+static void deriveChallenges(ProofValues& values, const function<uint64_t(uint64_t)>& s_at, uint64_t p) {
+  auto challenge = [&](uint64_t k) { return Polynomial::hashAndExtractLower4Bytes(s_at(k), p); };
+  values.alpha = challenge(0);
+  values.etaA = challenge(1);
+  values.etaB = challenge(2);
+  values.etaC = challenge(3);
+  values.beta1 = challenge(8);
+  values.beta2 = challenge(9);
+  for (uint64_t k = 10; k <= 30; k++) {
+    values.eta_p[k - 10] = challenge(k);
+  }
+}
+
+// Function to get the commitment of polynomial i of p(x): the index polynomials are committed in the commitment,
+// the others in the proof as Com_AHP2_x .. Com_AHP13_x
+static uint64_t polynomialCommitment(const VerifierKeys& keys, const ProofCodec::Proof& proof, uint64_t i) {
+  const uint64_t index[9] = {
+    keys.Com0_AHP, keys.Com1_AHP, keys.Com2_AHP, keys.Com3_AHP, keys.Com4_AHP, keys.Com5_AHP, keys.Com6_AHP, keys.Com7_AHP, keys.Com8_AHP
+  };
+  return i < 9 ? index[i] : proof.element("Com_AHP" + to_string(i - 7) + "_x");
+}
+
+// Function to evaluate both sides of eq1 to eq4 from the values of a proof
+static void fieldChecks(const VerifierKeys& keys, const ProofValues& values, ProofChecks& checks) {
+  const uint64_t n_i = keys.n_i, m = keys.m, n = keys.n, p = keys.p;
+  const uint64_t alpha = values.alpha, beta1 = values.beta1, beta2 = values.beta2, beta3 = values.index.beta3;
+  const uint64_t etaA = values.etaA, etaB = values.etaB, etaC = values.etaC;
+  const uint64_t sigma1 = values.sigma1, sigma2 = values.sigma2, sigma3 = values.sigma3;
+  const IndexEvaluations& index = values.index;
+  const uint64_t w_hat_beta1 = values.atBeta1[0], z_hatA_beta1 = values.atBeta1[1], z_hatB_beta1 = values.atBeta1[2];
+  const uint64_t z_hatC_beta1 = values.atBeta1[3], h_0_beta1 = values.atBeta1[4], s_beta1 = values.atBeta1[5];
+  const uint64_t g_1_beta1 = values.atBeta1[6], h_1_beta1 = values.atBeta1[7];
+  const uint64_t g_2_beta2 = values.atBeta2[0], h_2_beta2 = values.atBeta2[1];
+
+  // The verifier never builds a polynomial it only evaluates: vH(x) = x^n - 1 and vK(x) = x^m - 1 are evaluated
+  // directly, r(alpha, x) in closed form, and the index polynomials once at beta3, so every check below combines
+  // scalars
+  auto vH_at = [&](uint64_t x) { return Polynomial::subtractModP(Polynomial::power(x, n, p), 1, p); };
+  auto vK_at = [&](uint64_t x) { return Polynomial::subtractModP(Polynomial::power(x, m, p), 1, p); };
+  // r(alpha, x) = (alpha^n - x^n) / (alpha - x), which is n * alpha^(n-1) at x = alpha
+  auto r_alpha_at = [&](uint64_t x) {
+    if (x % p == alpha % p) {
+      return ((n % p) * Polynomial::power(alpha, n - 1, p)) % p;
+    }
+    uint64_t numerator = Polynomial::subtractModP(Polynomial::power(alpha, n, p), Polynomial::power(x, n, p), p);
+    return (numerator * Polynomial::pInverse(Polynomial::subtractModP(alpha % p, x % p, p), p)) % p;
+  };
+
+  uint64_t vH_beta1 = vH_at(beta1);
+  FIDES_LOG_DEBUG(cout << "vH(beta1) = " << vH_beta1 << endl);
+
+  uint64_t vH_beta2 = vH_at(beta2);
+  FIDES_LOG_DEBUG(cout << "vH(beta2) = " << vH_beta2 << endl);
+
+  // pi_M(beta3) = (row_M(beta3) - beta2)(col_M(beta3) - beta1) and sig_M(beta3) = eta_M vH(beta2) vH(beta1) val_M(beta3)
+  auto pi_at_beta3 = [&](uint64_t row, uint64_t col) {
+    return (Polynomial::subtractModP(row % p, beta2 % p, p) * Polynomial::subtractModP(col % p, beta1 % p, p)) % p;
+  };
+  uint64_t pi_a = pi_at_beta3(index.rowA, index.colA);
+  uint64_t pi_b = pi_at_beta3(index.rowB, index.colB);
+  uint64_t pi_c = pi_at_beta3(index.rowC, index.colC);
+  FIDES_LOG_DEBUG(cout << "pi_a(beta3) = " << pi_a << ", pi_b(beta3) = " << pi_b << ", pi_c(beta3) = " << pi_c << endl);
+
+  uint64_t vH_B2_vH_B1 = (vH_beta2 * vH_beta1) % p;
+  uint64_t sig_a = (((etaA * vH_B2_vH_B1) % p) * (index.valA % p)) % p;
+  uint64_t sig_b = (((etaB * vH_B2_vH_B1) % p) * (index.valB % p)) % p;
+  uint64_t sig_c = (((etaC * vH_B2_vH_B1) % p) * (index.valC % p)) % p;
+  FIDES_LOG_DEBUG(cout << "sig_a(beta3) = " << sig_a << ", sig_b(beta3) = " << sig_b << ", sig_c(beta3) = " << sig_c << endl);
+
+  uint64_t a_beta3 = (((sig_a * ((pi_b * pi_c) % p)) % p + (sig_b * ((pi_a * pi_c) % p)) % p) % p + (sig_c * ((pi_a * pi_b) % p)) % p) % p;
+  uint64_t b_beta3 = (((pi_a * pi_b) % p) * pi_c) % p;
+  FIDES_LOG_DEBUG(cout << "a(beta3) = " << a_beta3 << endl);
+  FIDES_LOG_DEBUG(cout << "b(beta3) = " << b_beta3 << endl);
+  FIDES_LOG_DEBUG(cout << "beta3 = " << beta3 << endl);
+  FIDES_LOG_DEBUG(cout << "sigma3 = " << sigma3 << endl);
+
+  uint64_t Sum_M_eta_M_z_hat_M_beta1 =
+    (((etaA * (z_hatA_beta1 % p)) % p + (etaB * (z_hatB_beta1 % p)) % p) % p + (etaC * (z_hatC_beta1 % p)) % p) % p;
+
+  // z_hat(beta1) = w_hat(beta1) v_H(beta1) + x_hat(beta1), with v_H vanishing on the first t points of H and
+  // x_hat interpolating 1 and the public inputs over them
+  uint64_t t = n_i + 1;
+  if (values.publicInputs.size() < n_i) {
+    throw std::runtime_error("Error: Fides proof has " + to_string(values.publicInputs.size()) + " public inputs, the commitment needs " + to_string(n_i));
+  }
+  const vector<uint64_t>& H = keys.H_t;
+  vector<uint64_t> zero_to_t_for_z;
+  zero_to_t_for_z.push_back(1);
+  for (uint64_t i = 0; i < n_i; i++) {
+    zero_to_t_for_z.push_back(values.publicInputs[i]);
+  }
+  vector<uint64_t> polyX_HAT_H = Polynomial::setupNewtonPolynomial(H, zero_to_t_for_z, p, "x_hat(h)");
+  uint64_t v_H_beta1 = 1;
+  for (uint64_t i = 0; i < t; i++) {
+    v_H_beta1 = (v_H_beta1 * Polynomial::subtractModP(beta1 % p, H[i], p)) % p;
+  }
+  uint64_t z_hat_beta1 = (((w_hat_beta1 % p) * v_H_beta1) % p + Polynomial::evaluatePolynomial(polyX_HAT_H, beta1, p)) % p;
+
+  checks.left[0] = ((values.h_3 % p) * vK_at(beta3)) % p;
+  uint64_t g_3_term = ((beta3 * (values.g_3 % p)) % p + (sigma3 * keys.inverse_m) % p) % p;
+  checks.right[0] = Polynomial::subtractModP(a_beta3, (b_beta3 * g_3_term) % p, p);
+
+  checks.left[1] = (r_alpha_at(beta2) * sigma3) % p;
+  checks.right[1] = (((h_2_beta2 % p) * vH_beta2) % p + (beta2 * (g_2_beta2 % p)) % p + (sigma2 * keys.inverse_n) % p) % p;
+
+  checks.left[2] = Polynomial::subtractModP(((s_beta1 % p) + (r_alpha_at(beta1) * Sum_M_eta_M_z_hat_M_beta1) % p) % p, (sigma2 * z_hat_beta1) % p, p);
+  checks.right[2] = (((h_1_beta1 % p) * vH_beta1) % p + (beta1 * (g_1_beta1 % p)) % p + (sigma1 * keys.inverse_n) % p) % p;
+
+  checks.left[3] = Polynomial::subtractModP(((z_hatA_beta1 % p) * (z_hatB_beta1 % p)) % p, z_hatC_beta1 % p, p);
+  checks.right[3] = ((h_0_beta1 % p) * vH_beta1) % p;
+}
+
+// Function to check a succinct proof: the challenges come from the opened values of s, the polynomials from
+// their opened evaluations, and the openings at beta1, beta2 and beta3 are folded with random coefficients rho_j
+// into the pairing equation e(sum rho_j (C_j - g y_j + z_j W_j), g) = e(sum rho_j W_j, vk), where C_j and y_j
+// weight the commitments and evaluations at point z_j with powers of a challenge hashed from them and W_j is its
+// opening
+static ProofChecks checkSuccinctProof(const VerifierKeys& keys, const ProofCodec::Proof& proofData) {
+  const uint64_t p = keys.p, g = keys.g;
+  const vector<uint64_t>& s_points = proofData.elements("P_AHP18");
+  const vector<uint64_t>& at_beta1 = proofData.elements("P_AHP20");
+  const vector<uint64_t>& at_beta2 = proofData.elements("P_AHP21");
+  const vector<uint64_t>& at_beta3 = proofData.elements("P_AHP22");
+  if (s_points.size() != ProofCodec::SUCCINCT_S_POINTS || at_beta1.size() != 8 || at_beta2.size() != 2 || at_beta3.size() != 11) {
+    throw std::runtime_error("Error: Fides succinct proof has the wrong number of evaluations");
+  }
+
+  ProofValues values;
+  values.sigma1 = proofData.element("P_AHP1");
+  values.sigma2 = proofData.element("P_AHP10");
+  values.sigma3 = proofData.element("P_AHP13");
+  deriveChallenges(values, [&](uint64_t k) { return s_points[k] % p; }, p);
+  values.publicInputs = proofData.elements("Com_AHP1_x");
+  copy(at_beta1.begin(), at_beta1.end(), values.atBeta1);
+  copy(at_beta2.begin(), at_beta2.end(), values.atBeta2);
+  // beta3 is hashed from s(31) and the commitments of g3 and h3, the same transcript as the prover's
+  values.index.beta3 = Polynomial::hashTranscript({ s_points[ProofCodec::SUCCINCT_S_POINTS - 1] % p, proofData.element("Com_AHP12_x") % p, proofData.element("Com_AHP13_x") % p }, p);
+  values.index.rowA = at_beta3[0];
+  values.index.colA = at_beta3[1];
+  values.index.valA = at_beta3[2];
+  values.index.rowB = at_beta3[3];
+  values.index.colB = at_beta3[4];
+  values.index.valB = at_beta3[5];
+  values.index.rowC = at_beta3[6];
+  values.index.colC = at_beta3[7];
+  values.index.valC = at_beta3[8];
+  values.g_3 = at_beta3[9];
+  values.h_3 = at_beta3[10];
+
+  ProofChecks checks;
+  fieldChecks(keys, values, checks);
+
+  FidesRandom::Engine& rng = FidesRandom::threadEngine();
+  std::uniform_int_distribution<uint64_t> coefficient(1, p - 1);
+  auto fold = [&](const vector<uint64_t>& terms, const vector<uint64_t>& evaluations, uint64_t point, uint64_t opening) {
+    // The polynomials of a point are weighted with the powers of a challenge hashed from the point, their
+    // commitments and the claimed evaluations, as the prover weighted them
+    vector<uint64_t> commitments;
+    for (uint64_t i : terms) {
+      commitments.push_back(polynomialCommitment(keys, proofData, i) % p);
+    }
+    vector<uint64_t> weights = Polynomial::openingWeights(point, commitments, evaluations, p);
+    uint64_t combined = 0, y = 0;
+    for (size_t j = 0; j < terms.size(); j++) {
+      combined = (combined + (weights[j] * commitments[j]) % p) % p;
+      y = (y + (weights[j] * (evaluations[j] % p)) % p) % p;
+    }
+    uint64_t left = (Polynomial::subtractModP(combined, (g * y) % p, p) + ((point % p) * (opening % p)) % p) % p;
+    uint64_t rho = coefficient(rng);
+    checks.eq51Buf = (checks.eq51Buf + rho * left) % p;
+    checks.p_17_AHP = (checks.p_17_AHP + rho * (opening % p)) % p;
+  };
+  fold({ 9, 10, 11, 12, 13, 14, 15, 16 }, at_beta1, values.beta1, proofData.element("P_AHP23"));
+  fold({ 17, 18 }, at_beta2, values.beta2, proofData.element("P_AHP24"));
+  fold({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 19, 20 }, at_beta3, values.index.beta3, proofData.element("P_AHP25"));
+  checks.x_prime = 0;
+
+  // s(0) .. s(31): e(Com(s) - Com(I_s), g) = e(W_s, Com(Z_s)), with I_s interpolating the values and Z_s
+  // vanishing on the points
+  vector<uint64_t> s_values;
+  for (uint64_t value : s_points) {
+    s_values.push_back(value % p);
+  }
+  vector<uint64_t> I_s = Polynomial::setupNewtonPolynomial(keys.S_points, s_values, p, "I_s(x)");
+  checks.sOpening = Polynomial::subtractModP(proofData.element("Com_AHP7_x") % p, keys.commitment->value(keys.commitment->commit(I_s)), p);
+  checks.sQuotient = proofData.element("P_AHP19") % p;
+  return checks;
+}
+
+ProofChecks Verifier::checkProof(const VerifierKeys& keys, const IndexEvaluations& index, const ProofCodec::Proof& proofData) {
+  if (proofData.succinct) {
+    return checkSuccinctProof(keys, proofData);
+  }
+  const uint64_t p = keys.p, g = keys.g;
+  const uint64_t beta3 = index.beta3;
+
+  ProofValues values;
+  values.sigma1 =             proofData.element("P_AHP1");
+  vector<uint64_t> w_hat_x =  proofData.elements("P_AHP2");
+  vector<uint64_t> z_hatA =   proofData.elements("P_AHP3");
+  vector<uint64_t> z_hatB =   proofData.elements("P_AHP4");
+  vector<uint64_t> z_hatC =   proofData.elements("P_AHP5");
+  vector<uint64_t> h_0_x =    proofData.elements("P_AHP6");
+  vector<uint64_t> s_x =      proofData.elements("P_AHP7");
+  vector<uint64_t> g_1_x =    proofData.elements("P_AHP8");
+  vector<uint64_t> h_1_x =    proofData.elements("P_AHP9");
+  values.sigma2 =             proofData.element("P_AHP10");
+  vector<uint64_t> g_2_x =    proofData.elements("P_AHP11");
+  vector<uint64_t> h_2_x =    proofData.elements("P_AHP12");
+  values.sigma3 =             proofData.element("P_AHP13");
+  vector<uint64_t> g_3_x =    proofData.elements("P_AHP14");
+  vector<uint64_t> h_3_x =    proofData.elements("P_AHP15");
+  uint64_t y_prime =          proofData.element("P_AHP16");
+  uint64_t p_17_AHP =         proofData.element("P_AHP17");
+  values.publicInputs =       proofData.elements("Com_AHP1_x");
+
+  // uint64_t input_value = proofJsonData.number("/input");
+  // uint64_t output_value = proofJsonData.number("/output");
+  // uint64_t ComP_AHP_x = proofJsonData.number("/ComP_AHP_x");
+  // string curve = proofJsonData["curve"];
+  // string protocol = proofJsonData["protocol"];
+
+  uint64_t x_prime = Polynomial::hashAndExtractLower4Bytes(Polynomial::evaluatePolynomial(s_x, 22, p), p);
+  deriveChallenges(values, [&](uint64_t k) { return Polynomial::evaluatePolynomial(s_x, k, p); }, p);
+
+  const vector<uint64_t>* at_beta1[8] = { &w_hat_x, &z_hatA, &z_hatB, &z_hatC, &h_0_x, &s_x, &g_1_x, &h_1_x };
+  for (int i = 0; i < 8; i++) {
+    values.atBeta1[i] = Polynomial::evaluatePolynomial(*at_beta1[i], values.beta1, p);
+  }
+  values.atBeta2[0] = Polynomial::evaluatePolynomial(g_2_x, values.beta2, p);
+  values.atBeta2[1] = Polynomial::evaluatePolynomial(h_2_x, values.beta2, p);
+  values.index = index;
+  values.g_3 = Polynomial::evaluatePolynomial(g_3_x, beta3, p);
+  values.h_3 = Polynomial::evaluatePolynomial(h_3_x, beta3, p);
+
+#if FIDES_LOG_LEVEL >= FIDES_LOG_LEVEL_DEBUG
+  // The output y is z_hatC at the last point of H
+  cout << "y = " << Polynomial::evaluatePolynomial(z_hatC, keys.H_last, p) << endl;
+#endif
+  FIDES_LOG_DEBUG(Polynomial::printPolynomial(g_3_x, "g_3_x"));
+
+  ProofChecks checks;
+  fieldChecks(keys, values, checks);
+
+  // p(x) weights every committed polynomial with its eta_p, so its commitment is the same combination of theirs
+  uint64_t ComP_AHP_x = 0;
+  for (uint64_t i = 0; i < 21; i++) {
+    ComP_AHP_x = (ComP_AHP_x + (polynomialCommitment(keys, proofData, i) * values.eta_p[i]) % p) % p;
+  }
+  FIDES_LOG_DEBUG(cout << "ComP_AHP_x = " << ComP_AHP_x << endl);
+
+  checks.eq51Buf = Polynomial::subtractModP(ComP_AHP_x, (g * y_prime), p);
+  checks.p_17_AHP = p_17_AHP;
+  checks.x_prime = x_prime;
+  return checks;
+}
+
+pair<uint64_t, uint64_t> Verifier::pairingSides(const VerifierKeys& keys, const ProofChecks& checks) {
+  uint64_t eq51 = Polynomial::e_func(checks.eq51Buf, keys.g, keys.g, keys.p);
+  uint64_t eq52BufP2 = Polynomial::subtractModP(keys.vk, (keys.g * checks.x_prime), keys.p);
+  uint64_t eq52 = Polynomial::e_func(checks.p_17_AHP, eq52BufP2, keys.g, keys.p);
+  return { eq51, eq52 };
+}
+
+// Function to check eq5 with the commitment backend: eq51Buf is Com(p) - g y', so eq5 is the opening of a
+// polynomial with that commitment to 0 at x_prime, with proof p_17_AHP
+static bool openingHolds(const VerifierKeys& keys, uint64_t eq51Buf, uint64_t x_prime, uint64_t p_17_AHP) {
+  const CommitmentBackend& backend = *keys.commitment;
+  CommitmentBackend::Opening opening;
+  opening.values.push_back(backend.element(0));
+  opening.proof = backend.element(p_17_AHP);
+  return backend.verify({ backend.element(eq51Buf) }, { 1 }, x_prime, opening);
+}
+
+bool Verifier::checksHold(const VerifierKeys& keys, const ProofChecks& checks) {
+  for (int i = 0; i < 4; i++) {
+    if (checks.left[i] != checks.right[i]) {
+      return false;
+    }
+  }
+  return openingHolds(keys, checks.eq51Buf, checks.x_prime, checks.p_17_AHP)
+    && keys.commitment->verifyDivision(keys.commitment->element(checks.sOpening), keys.commitment->element(checks.sQuotient), keys.Com_Z_s);
+}
+
+vector<bool> Verifier::verifyBatch(const VerifierKeys& keys, const vector<ProofCodec::Proof>& proofs) {
+  const uint64_t p = keys.p;
+  // Succinct proofs carry the index polynomials at beta3, so only full proofs need them evaluated
+  bool anyFull = any_of(proofs.begin(), proofs.end(), [](const ProofCodec::Proof& proof) { return !proof.succinct; });
+  IndexEvaluations index = anyFull ? evaluateIndex(keys) : IndexEvaluations();
+
+  FidesRandom::Engine& rng = FidesRandom::threadEngine();
+  std::uniform_int_distribution<uint64_t> coefficient(1, p - 1);
+  uint64_t fieldFold = 0, pairingLeft = 0, pairingRight = 0, openingLeft = 0, openingRight = 0;
+  vector<bool> verified(proofs.size(), false);
+  vector<ProofChecks> checked(proofs.size());
+  for (size_t i = 0; i < proofs.size(); i++) {
+    try {
+      if (proofs[i].commitmentId != keys.commitmentID) {
+        throw std::runtime_error("Error: Fides proof belongs to commitment " + proofs[i].commitmentId);
+      }
+      ProofChecks checks = checkProof(keys, index, proofs[i]);
+      for (int j = 0; j < 4; j++) {
+        fieldFold = (fieldFold + coefficient(rng) * Polynomial::subtractModP(checks.left[j], checks.right[j], p)) % p;
+      }
+      uint64_t rho = coefficient(rng);
+      uint64_t left = (checks.eq51Buf + ((checks.x_prime % p) * (checks.p_17_AHP % p)) % p) % p;
+      pairingLeft = (pairingLeft + rho * left) % p;
+      pairingRight = (pairingRight + rho * (checks.p_17_AHP % p)) % p;
+      rho = coefficient(rng);
+      openingLeft = (openingLeft + rho * (checks.sOpening % p)) % p;
+      openingRight = (openingRight + rho * (checks.sQuotient % p)) % p;
+      checked[i] = checks;
+      verified[i] = true;
+    } catch (const std::exception& error) {
+      FIDES_LOG_DEBUG(cerr << "Proof " << i << " failed: " << error.what() << endl);
+    }
+  }
+
+  const CommitmentBackend& backend = *keys.commitment;
+  bool folded = fieldFold == 0 && openingHolds(keys, pairingLeft, 0, pairingRight)
+    && backend.verifyDivision(backend.element(openingLeft), backend.element(openingRight), keys.Com_Z_s);
+  if (!folded) {
+    for (size_t i = 0; i < proofs.size(); i++) {
+      verified[i] = verified[i] && checksHold(keys, checked[i]);
+    }
+  }
+  return verified;
+}
+
+// Verifying keys of the most recently used commitments of a daemon, shared by its workers. Keys are loaded
+// outside the lock, so a slow load never holds up verifications of commitments already cached
+class VerifierKeyCache {
+public:
+  VerifierKeyCache(const std::string& root, size_t capacity) : root(root), capacity(capacity == 0 ? 1 : capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    scan();
+  }
+
+  // Function to get the keys of a commitment, loading them and evicting the least recently used on a miss
+  shared_ptr<const VerifierKeys> find(const std::string& commitmentId) {
+    std::string directory;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto cached = entries.find(commitmentId);
+      if (cached != entries.end()) {
+        order.splice(order.begin(), order, cached->second);
+        return cached->second->second;
+      }
+      auto known = directories.find(commitmentId);
+      if (known == directories.end()) {
+        // A commitment deployed after the daemon started is found by scanning root again, at most once a second
+        if (chrono::steady_clock::now() - lastScan > chrono::seconds(1)) {
+          scan();
+        }
+        known = directories.find(commitmentId);
+        if (known == directories.end()) {
+          throw std::runtime_error("Error: Fides verifier has no keys for commitment " + commitmentId);
+        }
+      }
+      directory = known->second;
+    }
+
+    shared_ptr<const VerifierKeys> keys = make_shared<const VerifierKeys>(Verifier::loadKeys(directory));
+    if (keys->commitmentID != commitmentId) {
+      throw std::runtime_error("Error: Fides commitment in " + directory + " changed to " + keys->commitmentID);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto cached = entries.find(commitmentId);
+    if (cached != entries.end()) {
+      return cached->second->second;
+    }
+    order.emplace_front(commitmentId, keys);
+    entries[commitmentId] = order.begin();
+    if (order.size() > capacity) {
+      FIDES_LOG_DEBUG(cout << "Evicting the keys of commitment " << order.back().first << endl);
+      entries.erase(order.back().first);
+      order.pop_back();
+    }
+    FIDES_LOG_INFO(cout << "Loaded the keys of commitment " << commitmentId << " (class " << keys->Class << ") from " << directory << endl);
+    return keys;
+  }
+
+private:
+  // Function to map the commitment id of root and of each of its subdirectories to that directory
+  void scan() {
+    lastScan = chrono::steady_clock::now();
+    vector<std::string> candidates = { root };
+    if (DIR* directory = opendir(root.c_str())) {
+      while (dirent* entry = readdir(directory)) {
+        if (entry->d_name[0] != '.') {
+          candidates.push_back(root + "/" + entry->d_name);
+        }
+      }
+      closedir(directory);
+    }
+    for (const std::string& candidate : candidates) {
+      JsonLoader commitment;
+      if (access((candidate + "/program_commitment.json").c_str(), R_OK) == 0 && commitment.loadFile(candidate + "/program_commitment.json") && commitment.has("/commitmentId")) {
+        directories[commitment.text("/commitmentId")] = candidate;
+      }
+    }
+  }
+
+  std::string root;
+  size_t capacity;
+  std::mutex mutex;
+  unordered_map<std::string, std::string> directories;
+  chrono::steady_clock::time_point lastScan;
+  list<pair<std::string, shared_ptr<const VerifierKeys>>> order;
+  unordered_map<std::string, list<pair<std::string, shared_ptr<const VerifierKeys>>>::iterator> entries;
+};
+
+// Function to verify one request of a daemon and build its JSON reply
+static ordered_json verifyRequest(VerifierKeyCache& cache, const vector<uint8_t>& request) {
+  auto start_time = chrono::high_resolution_clock::now();
+  ordered_json reply;
+  reply["status"] = 2;
+  reply["verified"] = false;
+  reply["commitmentId"] = "";
+  try {
+    ProofCodec::Proof proof = ProofCodec::parse(request);
+    reply["commitmentId"] = proof.commitmentId;
+    shared_ptr<const VerifierKeys> keys = cache.find(proof.commitmentId);
+    // beta3 is drawn for every request, so a prover never learns the point its next proof is checked at
+    bool verified = false;
+    try {
+      IndexEvaluations index = proof.succinct ? IndexEvaluations() : Verifier::evaluateIndex(*keys);
+      verified = Verifier::checksHold(*keys, Verifier::checkProof(*keys, index, proof));
+    } catch (const std::exception& error) {
+      reply["error"] = error.what();
+    }
+    reply["status"] = verified ? 0 : 1;
+    reply["verified"] = verified;
+  } catch (const std::exception& error) {
+    reply["error"] = error.what();
+  }
+  reply["microseconds"] = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start_time).count();
+  return reply;
+}
+
+void Verifier::serve(const std::string& root, const std::string& address, size_t cacheSize, unsigned threads) {
+  VerifierKeyCache cache(root, cacheSize);
+  int server = FidesSocket::open(address, true);
+  FIDES_LOG_INFO(cout << "Verifier for the commitments in " << root << " listening on " << address << " with " << threads << " workers" << endl);
+
+  // The accepting thread queues connections and the workers verify them, each connection one request
+  std::mutex queueMutex;
+  std::condition_variable queued;
+  deque<int> clients;
+  auto worker = [&] {
+    while (true) {
+      int client;
+      {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queued.wait(lock, [&] { return !clients.empty(); });
+        client = clients.front();
+        clients.pop_front();
+      }
+      uint64_t size = 0;
+      vector<uint8_t> request;
+      if (FidesSocket::readFully(client, &size, sizeof(size)) && size <= MAX_PROOF_MESSAGE) {
+        request.resize(size);
+      }
+      if (size == request.size() && FidesSocket::readFully(client, request.data(), size)) {
+        ordered_json result = verifyRequest(cache, request);
+        if (result["status"] != 0) {
+          FIDES_LOG_ERROR(cerr << result.dump() << endl);
+        }
+        std::string reply = result.dump();
+        uint64_t replySize = reply.size();
+        FidesSocket::writeFully(client, &replySize, sizeof(replySize)) && FidesSocket::writeFully(client, reply.data(), replySize);
+      }
+      close(client);
+    }
+  };
+  vector<thread> workers;
+  for (unsigned i = 0; i < (threads == 0 ? 1 : threads); i++) {
+    workers.emplace_back(worker);
+  }
+  while (true) {
+    int client = accept(server, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      clients.push_back(client);
+    }
+    queued.notify_one();
+  }
+}
+
+std::string Verifier::requestVerification(const std::string& address, const vector<uint8_t>& proof) {
+  int client = FidesSocket::open(address, false);
+  uint64_t size = proof.size();
+  std::string reply;
+  bool ok = FidesSocket::writeFully(client, &size, sizeof(size)) && FidesSocket::writeFully(client, proof.data(), size)
+    && FidesSocket::readFully(client, &size, sizeof(size)) && size <= MAX_PROOF_MESSAGE;
+  if (ok) {
+    reply.resize(size);
+    ok = FidesSocket::readFully(client, &reply[0], size);
+  }
+  close(client);
+  if (!ok) {
+    throw std::runtime_error("Error: Fides verifier at " + address + " closed the connection");
+  }
+  return reply;
+}
+
+size_t Verifier::cacheSizeFromEnv() {
+  const char* env = getenv("FIDESINNOVA_VERIFIER_CACHE");
+  if (env != nullptr && atoi(env) > 0) {
+    return atoi(env);
+  }
+  return 16;
+}
@@ -0,0 +1,110 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <memory>
+#include <cstdint>
+#include "proofCodec.h"
+#include "commitmentBackend.h"
+
+using namespace std;
+
+// Everything the checks of one commitment share: the commitment, setup and class files and the constants derived
+// from them. Loaded once per commitment and only read while verifying.
+struct VerifierKeys {
+  std::string directory = ".";
+  std::string commitmentID;
+  uint64_t Class = 0;
+  vector<uint64_t> rowA_x, colA_x, valA_x, rowB_x, colB_x, valB_x, rowC_x, colC_x, valC_x;
+  uint64_t Com0_AHP = 0, Com1_AHP = 0, Com2_AHP = 0, Com3_AHP = 0, Com4_AHP = 0, Com5_AHP = 0, Com6_AHP = 0, Com7_AHP = 0, Com8_AHP = 0;
+  vector<uint64_t> ck;
+  uint64_t vk = 0;
+  // Commitment scheme over the setup, chosen with FIDESINNOVA_COMMITMENT_BACKEND like the prover's
+  shared_ptr<const CommitmentBackend> commitment;
+  uint64_t n_i = 0, n_g = 0, m = 0, n = 0, p = 0, g = 0;
+
+  // The first t = n_i + 1 points of H, its last point, and the inverses of n and m
+  vector<uint64_t> H_t;
+  uint64_t H_last = 0, inverse_n = 0, inverse_m = 0;
+
+  // The points a succinct proof opens s(x) at, and the commitment of Z_s(x), the polynomial vanishing on them
+  vector<uint64_t> S_points;
+  CommitmentBackend::Element Com_Z_s;
+};
+
+// The index polynomials at beta3. beta3 is the verifier's own random point, drawn once the proofs are fixed, so a
+// batch draws it once and evaluates the index polynomials once for all of its proofs
+struct IndexEvaluations {
+  uint64_t beta3 = 0;
+  uint64_t rowA = 0, colA = 0, valA = 0, rowB = 0, colB = 0, valB = 0, rowC = 0, colC = 0, valC = 0;
+};
+
+// Both sides of every check of one proof: eq1 to eq4 compare field elements, and eq5 is the pairing equation
+// e(eq51Buf, g) = e(p_17_AHP, vk - g * x_prime). A succinct proof adds the opening of s(x) at its challenge points,
+// e(sOpening, g) = e(sQuotient, Com(Z_s)), which holds trivially with both 0 for a full proof
+struct ProofChecks {
+  uint64_t left[4] = { 0, 0, 0, 0 };
+  uint64_t right[4] = { 0, 0, 0, 0 };
+  uint64_t eq51Buf = 0, p_17_AHP = 0, x_prime = 0;
+  uint64_t sOpening = 0, sQuotient = 0;
+};
+
+// Reentrant verifier: every call only reads its keys, so any number of threads can verify against the same keys
+// at once. Errors are thrown as std::runtime_error.
+class Verifier {
+public:
+  // Function to load program_commitment.json, data/setupN.json and class.json from directory
+  static VerifierKeys loadKeys(const std::string& directory = ".");
+
+  // Function to draw beta3 and evaluate the index polynomials at it, which only full proofs need
+  static IndexEvaluations evaluateIndex(const VerifierKeys& keys);
+
+  // Function to derive the challenges of a proof and evaluate both sides of its checks. A succinct proof carries
+  // its evaluations and openings, so index is not read and the work does not grow with the class
+  static ProofChecks checkProof(const VerifierKeys& keys, const IndexEvaluations& index, const ProofCodec::Proof& proof);
+
+  // Function to evaluate both sides of the pairing equation of a proof
+  static pair<uint64_t, uint64_t> pairingSides(const VerifierKeys& keys, const ProofChecks& checks);
+
+  // Function to tell whether every check of one proof holds
+  static bool checksHold(const VerifierKeys& keys, const ProofChecks& checks);
+
+  // Function to verify proofs of the commitment of keys; a proof of another commitment or with missing entries
+  // fails. One beta3 serves the whole batch, and the checks of all proofs are folded with random coefficients
+  // rho_i into one field equation, sum rho_i (left_i - right_i) = 0, and one pairing equation,
+  // e(sum rho_i (eq51Buf_i + x_prime_i p_17_i), g) = e(sum rho_i p_17_i, vk). Both hold by bilinearity when every
+  // proof holds and otherwise fail except with probability about 1/p; only then are the proofs checked one by one
+  static vector<bool> verifyBatch(const VerifierKeys& keys, const vector<ProofCodec::Proof>& proofs);
+
+  // Function to serve verifications on address, "tcp:host:port" or a Unix domain socket path, until the process
+  // is stopped. The keys of a commitment are found in the subdirectories of root, loaded on first use and kept in
+  // a cache of the cacheSize most recently used commitments. A request is a uint64_t length and a binary or JSON
+  // proof; the reply is a uint64_t length and a JSON object with "status" (0 verified, 1 rejected, 2 error),
+  // "verified", "commitmentId", "microseconds" and, on errors, "error"
+  static void serve(const std::string& root, const std::string& address, size_t cacheSize, unsigned threads);
+
+  // Function to send a proof to a verifier started with serve and return its JSON reply
+  static std::string requestVerification(const std::string& address, const vector<uint8_t>& proof);
+
+  // Function to read FIDESINNOVA_VERIFIER_CACHE, the number of commitments a verifier daemon keeps loaded (16 when unset)
+  static size_t cacheSizeFromEnv();
+};
+
+#endif  // VERIFIER_H
@@ -0,0 +1,180 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef WITNESSRING_H
+#define WITNESSRING_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <stdexcept>
+#include <cstring>
+#include <new>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Lock-free single-producer single-consumer ring of witness snapshots.
+// The device program pushes z_array into a slot and returns; a prover thread or process pops and proves it.
+// The ring lives in POSIX shared memory when it has a name (e.g. "/fidesinnova-witness"), so the prover can be a
+// separate process, or in private memory of the process otherwise. The producer never waits: when every slot is
+// taken the snapshot is dropped and counted. The header records the commitment id of the consumer, so a program
+// built for another commitment can refuse the ring instead of filling it with witnesses that cannot be proved.
+// Header only, so the device program and proverDaemon link it without extra sources.
+class WitnessRing {
+public:
+  static constexpr uint64_t DEFAULT_CAPACITY = 16;
+  static constexpr size_t COMMITMENT_ID_SIZE = 128;
+
+  // Function to create a ring of capacity slots of slotSize values for the witnesses of commitmentId; a named ring
+  // replaces any previous one
+  WitnessRing(const std::string& name, uint64_t slotSize, const std::string& commitmentId = "", uint64_t capacity = DEFAULT_CAPACITY) : name(name), owner(true) {
+    if (slotSize == 0 || capacity == 0) {
+      throw std::runtime_error("Error: Fides witness ring needs a nonzero slot size and capacity");
+    }
+    if (commitmentId.size() >= COMMITMENT_ID_SIZE) {
+      throw std::runtime_error("Error: Fides commitment id " + commitmentId + " does not fit the witness ring header");
+    }
+    bytes = sizeof(Header) + slotSize * capacity * sizeof(uint64_t);
+    void* memory;
+    if (name.empty()) {
+      memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    } else {
+      shm_unlink(name.c_str());
+      int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd < 0 || ftruncate(fd, bytes) != 0) {
+        if (fd >= 0) {
+          close(fd);
+        }
+        throw std::runtime_error("Error: Fides cannot create the witness ring " + name);
+      }
+      memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+    }
+    if (memory == MAP_FAILED) {
+      throw std::runtime_error("Error: Fides cannot map the witness ring " + name);
+    }
+    header = new (memory) Header();
+    header->slotSize = slotSize;
+    header->capacity = capacity;
+    memcpy(header->commitmentId, commitmentId.data(), commitmentId.size());
+    slots = reinterpret_cast<uint64_t*>(header + 1);
+    // The magic is published last, so a producer that opens the ring early never sees a half-written header
+    atomic_thread_fence(memory_order_release);
+    header->magic = MAGIC;
+  }
+
+  // Function to open the named ring created by the consumer
+  explicit WitnessRing(const std::string& name) : name(name), owner(false) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      throw std::runtime_error("Error: Fides witness ring " + name + " does not exist; start proverDaemon first");
+    }
+    Header probe;
+    bool readable = pread(fd, &probe, sizeof(probe), 0) == (ssize_t)sizeof(probe);
+    if (!readable || probe.magic != MAGIC) {
+      close(fd);
+      throw std::runtime_error("Error: Fides " + name + " is not a witness ring");
+    }
+    bytes = sizeof(Header) + probe.slotSize * probe.capacity * sizeof(uint64_t);
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+      throw std::runtime_error("Error: Fides cannot map the witness ring " + name);
+    }
+    header = static_cast<Header*>(memory);
+    slots = reinterpret_cast<uint64_t*>(header + 1);
+  }
+
+  WitnessRing(const WitnessRing&) = delete;
+  WitnessRing& operator=(const WitnessRing&) = delete;
+
+  ~WitnessRing() {
+    munmap(header, bytes);
+    if (owner && !name.empty()) {
+      shm_unlink(name.c_str());
+    }
+  }
+
+  // Function to copy slotSize values into the next free slot (producer only); returns false if the ring is full
+  bool push(const uint64_t* values) {
+    uint64_t head = header->head.load(memory_order_relaxed);
+    if (head - header->tail.load(memory_order_acquire) == header->capacity) {
+      header->dropped.fetch_add(1, memory_order_relaxed);
+      return false;
+    }
+    memcpy(slots + (head % header->capacity) * header->slotSize, values, header->slotSize * sizeof(uint64_t));
+    header->head.store(head + 1, memory_order_release);
+    return true;
+  }
+
+  // Function to move the oldest snapshot into values (consumer only); returns false if the ring is empty
+  bool pop(vector<uint64_t>& values) {
+    uint64_t tail = header->tail.load(memory_order_relaxed);
+    if (header->head.load(memory_order_acquire) == tail) {
+      return false;
+    }
+    const uint64_t* slot = slots + (tail % header->capacity) * header->slotSize;
+    values.assign(slot, slot + header->slotSize);
+    header->tail.store(tail + 1, memory_order_release);
+    return true;
+  }
+
+  // Function to get the number of snapshots waiting to be popped
+  uint64_t pending() const {
+    return header->head.load(memory_order_acquire) - header->tail.load(memory_order_relaxed);
+  }
+
+  // Function to get the number of values in a snapshot
+  uint64_t slotSize() const {
+    return header->slotSize;
+  }
+
+  // Function to get the commitment id the consumer proves for (empty if the creator gave none)
+  std::string commitmentId() const {
+    return std::string(header->commitmentId, strnlen(header->commitmentId, COMMITMENT_ID_SIZE));
+  }
+
+  // Function to get the number of snapshots dropped because the ring was full
+  uint64_t dropped() const {
+    return header->dropped.load(memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint64_t MAGIC = 0x32474e5257534446;  // "FDSWRNG2"
+  static_assert(atomic<uint64_t>::is_always_lock_free, "the witness ring needs lock-free 64-bit atomics");
+
+  // Producer and consumer indices sit on their own cache lines so the two sides do not contend
+  struct Header {
+    uint64_t magic = 0;
+    uint64_t slotSize = 0;
+    uint64_t capacity = 0;
+    char commitmentId[COMMITMENT_ID_SIZE] = {};
+    alignas(64) atomic<uint64_t> head{0};
+    alignas(64) atomic<uint64_t> tail{0};
+    atomic<uint64_t> dropped{0};
+  };
+
+  std::string name;
+  bool owner;
+  size_t bytes = 0;
+  Header* header = nullptr;
+  uint64_t* slots = nullptr;
+};
+
+#endif  // WITNESSRING_H
@@ -0,0 +1,92 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lib/prover.h"
+#include "lib/fidesLog.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+
+using namespace std;
+
+// Long-running prover: loads the commitment, param, class and setup files of the working directory once and
+// proves every witness sent to its address, a Unix domain socket path or "tcp:host:port". Run the program with
+// FIDESINNOVA_PROVER_SOCKET set to the same address to hand its z_array to the daemon instead of proving in the
+// program. Further arguments are project directories whose commitments are served as well, so one daemon on a fast
+// host can prove for a fleet of devices; each witness carries the id of its commitment.
+// With FIDESINNOVA_WITNESS_RING set (e.g. "/fidesinnova-witness") it creates that shared-memory ring instead and
+// writes a proof to data/ for every snapshot the program's submitWitness pushes to it.
+// With FIDESINNOVA_OFFLINE_POOL=N it keeps N offline sets (the witness-independent part of a proof) in data/
+// while idle; "proverDaemon --precompute N" stores N sets and exits, for a program that proves by itself.
+// "proverDaemon --submit address witness.bin [proof.bin]" sends a witness exported with FIDESINNOVA_WITNESS_EXPORT
+// to a running daemon and writes the proof it returns (data/proof.bin by default).
+int main(int argc, char* argv[]) {
+  std::string address = argc > 1 ? argv[1] : "/tmp/fidesinnova-prover.sock";
+  if (address == "--submit") {
+    if (argc < 4) {
+      cerr << "Usage: proverDaemon --submit address witness.bin [proof.bin]" << endl;
+      return 1;
+    }
+    std::ifstream witnessFile(argv[3], ios::binary);
+    if (!witnessFile.is_open()) {
+      cerr << "Error: Fides cannot open " << argv[3] << endl;
+      return 1;
+    }
+    vector<uint8_t> witness((istreambuf_iterator<char>(witnessFile)), istreambuf_iterator<char>());
+    std::string proofPath = argc > 4 ? argv[4] : "data/proof.bin";
+    vector<uint8_t> proof;
+    try {
+      proof = Prover::requestProof(argv[2], witness);
+    } catch (const std::exception& error) {
+      cerr << error.what() << endl;
+      return 1;
+    }
+    if (!ProofCodec::writeFile(proofPath, proof)) {
+      cerr << "Error: Fides cannot write " << proofPath << endl;
+      return 1;
+    }
+    FIDES_LOG_INFO(cout << "Proof data has been written at " << proofPath << endl);
+    return 0;
+  }
+
+  ProverKeys keys = Prover::loadKeys();
+  if (address == "--precompute") {
+    uint64_t count = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    for (uint64_t i = 0; i < count; i++) {
+      Prover::storeOffline(keys, Prover::precompute(keys, Prover::memoryBudgetFromEnv()));
+    }
+    FIDES_LOG_INFO(cout << Prover::offlineCount(keys) << " offline sets stored for commitment " << keys.commitmentID << endl);
+    return 0;
+  }
+  const char* ringName = getenv("FIDESINNOVA_WITNESS_RING");
+  if (ringName != nullptr) {
+    WitnessRing ring(ringName, 1 + keys.n_i + keys.n_g, keys.commitmentID);
+    atomic<bool> stop(false);
+    FIDES_LOG_INFO(cout << "Prover for commitment " << keys.commitmentID << " (class " << keys.Class << ") reading witness ring " << ringName << endl);
+    Prover::consume(keys, ring, stop);
+    return 0;
+  }
+  vector<ProverKeys> commitments;
+  commitments.push_back(std::move(keys));
+  for (int i = 2; i < argc; i++) {
+    commitments.push_back(Prover::loadKeys(argv[i], false));
+  }
+  Prover::serve(commitments, address);
+  return 0;
+}
@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <fstream>
 #include "../lib/json.hpp"
+#include "../lib/fidesRandom.h"
 using ordered_json = nlohmann::ordered_json;
 #include <regex>
 #include <iostream>
@@ -71,8 +72,7 @@ void setup() {
                 // Calculate new power for g based on d_AHP
                 uint64_t pMinusOne = p - 1;
 
-                std::random_device rd;
-                std::mt19937 gen(rd());
+                FidesRandom::Engine& gen = FidesRandom::threadEngine();
                 std::uniform_int_distribution<uint64_t> dis(1, pMinusOne);
                 uint64_t tau = dis(gen);
                 tau %= pMinusOne;
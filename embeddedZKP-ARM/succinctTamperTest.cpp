@@ -0,0 +1,71 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lib/verifier.h"
+#include "lib/polynomial.h"
+#include "lib/proofCodec.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Function to get a copy of proof whose evaluations of w_hat and z_hatA at beta1 are shifted in opposite
+// directions, so that their sum weighted with eta_p, which the prover knows before it claims them, is unchanged
+static ProofCodec::Proof shiftEvaluations(const ProofCodec::Proof& proof, uint64_t p) {
+  ProofCodec::Proof tampered = proof;
+  const vector<uint64_t>& s_points = proof.elements("P_AHP18");
+  // w_hat and z_hatA are polynomials 9 and 10 of p(x), weighted with the challenges hashed from s(19) and s(20)
+  uint64_t eta_w = Polynomial::hashAndExtractLower4Bytes(s_points[19] % p, p);
+  uint64_t eta_z = Polynomial::hashAndExtractLower4Bytes(s_points[20] % p, p);
+  vector<uint64_t>& at_beta1 = tampered.entries["P_AHP20"];
+  at_beta1[0] = (at_beta1[0] % p + eta_z) % p;
+  at_beta1[1] = Polynomial::subtractModP(at_beta1[1] % p, eta_w, p);
+  return tampered;
+}
+
+// Soundness check of succinct proofs: "succinctTamperTest [proof]" reads a succinct proof (data/proof.bin or
+// data/proof.json by default) and the keys of the working directory, checks that the proof verifies, and that
+// the same proof with two evaluations at beta1 shifted as above is rejected by the opening at beta1, alone and in
+// a batch. Exits with 0 if both hold and 1 otherwise
+int main(int argc, char* argv[]) {
+  std::string proofPath = argc > 1 ? argv[1] : (std::ifstream("data/proof.bin").good() ? "data/proof.bin" : "data/proof.json");
+  try {
+    VerifierKeys keys = Verifier::loadKeys();
+    ProofCodec::Proof proof = ProofCodec::readFile(proofPath);
+    if (!proof.succinct) {
+      throw std::runtime_error("Error: Fides " + proofPath + " is not a succinct proof; prove with FIDESINNOVA_PROOF_MODE=succinct");
+    }
+    ProofCodec::Proof tampered = shiftEvaluations(proof, keys.p);
+
+    bool accepted = Verifier::checksHold(keys, Verifier::checkProof(keys, IndexEvaluations(), proof));
+    ProofChecks tamperedChecks = Verifier::checkProof(keys, IndexEvaluations(), tampered);
+    pair<uint64_t, uint64_t> pairing = Verifier::pairingSides(keys, tamperedChecks);
+    bool openingRejected = pairing.first != pairing.second;
+    bool rejected = !Verifier::checksHold(keys, tamperedChecks);
+    vector<bool> batch = Verifier::verifyBatch(keys, { proof, tampered });
+    bool batchRejected = batch[0] && !batch[1];
+
+    cout << "proof verifies:                   " << (accepted ? "yes" : "NO") << endl;
+    cout << "shifted evaluations fail opening: " << (openingRejected ? "yes" : "NO") << endl;
+    cout << "shifted evaluations rejected:     " << (rejected ? "yes" : "NO") << endl;
+    cout << "rejected in a batch:              " << (batchRejected ? "yes" : "NO") << endl;
+    return accepted && openingRejected && rejected && batchRejected ? 0 : 1;
+  } catch (const std::exception& error) {
+    cerr << error.what() << endl;
+    return 2;
+  }
+}
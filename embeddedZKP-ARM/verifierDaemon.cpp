@@ -0,0 +1,67 @@
+// Copyright 2025 Fidesinnova.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "lib/verifier.h"
+#include "lib/taskGraph.h"
+#include "lib/json.hpp"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Long-running verifier for many devices: "verifierDaemon address [root]" verifies every proof sent to its
+// address, a Unix domain socket path or "tcp:host:port". root (the working directory by default) and each of its
+// subdirectories may hold a project with program_commitment.json, data/setupN.json and class.json; the keys of a
+// commitment are loaded on its first proof and the FIDESINNOVA_VERIFIER_CACHE most recently used (16 by default)
+// stay loaded. FIDESINNOVA_THREADS proofs are verified at once (one per core by default).
+// "verifierDaemon --submit address proof.file" sends a binary or JSON proof to a running daemon, prints its JSON
+// reply and exits with its status: 0 verified, 1 rejected, 2 error.
+int main(int argc, char* argv[]) {
+  std::string address = argc > 1 ? argv[1] : "/tmp/fidesinnova-verifier.sock";
+  if (address == "--submit") {
+    if (argc < 4) {
+      cerr << "Usage: verifierDaemon --submit address proof.file" << endl;
+      return 2;
+    }
+    std::ifstream proofFile(argv[3], ios::binary);
+    if (!proofFile.is_open()) {
+      cerr << "Error: Fides cannot open " << argv[3] << endl;
+      return 2;
+    }
+    vector<uint8_t> proof((istreambuf_iterator<char>(proofFile)), istreambuf_iterator<char>());
+    std::string reply;
+    try {
+      reply = Verifier::requestVerification(argv[2], proof);
+    } catch (const std::exception& error) {
+      cerr << error.what() << endl;
+      return 2;
+    }
+    cout << reply << endl;
+    nlohmann::json result = nlohmann::json::parse(reply, nullptr, false);
+    return result.is_object() && result["status"].is_number() ? result["status"].get<int>() : 2;
+  }
+
+  std::string root = argc > 2 ? argv[2] : ".";
+  try {
+    Verifier::serve(root, address, Verifier::cacheSizeFromEnv(), TaskGraph::defaultThreads());
+  } catch (const std::exception& error) {
+    cerr << error.what() << endl;
+    return 2;
+  }
+  return 0;
+}
@@ -119,7 +119,7 @@ case $user_choice in
 
         # Step 8: Build the program_AddedFidesProofGen.s using the updated codes and store the output logs
         echo "[8/$total_steps] Build the executable from program_AddedFidesProofGen.s"
-        g++ -std=c++17 program_AddedFidesProofGen.s lib/polynomial.cpp -o program -lstdc++
+        g++ -std=c++17 program_AddedFidesProofGen.s lib/polynomial.cpp lib/taskGraph.cpp lib/prover.cpp -o program -lstdc++ -pthread
         if [ $? -ne 0 ]; then
             echo "Build failed"
             exit 1